@@ -6,19 +6,264 @@
  *
  */
 
+#include <QApplication>
 #include <QPainter>
+#include <QPixmapCache>
 #include <QStyleOption>
+#include <QVariant>
+#include <QWidget>
 
 #include "applicationproxystyle.h"
+#include "paintbudgetmonitor.h"
+
+using CreatorStyleEdit::Internal::IconTint;
+using CreatorStyleEdit::Internal::PaintBudgetMonitor;
+using CreatorStyleEdit::Internal::ThemeMapping;
+
+// Results for option rectangles change with every resize, so the caches are dropped once they
+// get this large
+static const int maximumMetricsCacheSize = 4096;
+// Pixmaps that are created for every paint would fill the tinted pixmap cache forever
+static const int maximumTintedPixmapCacheSize = 2048;
+// Deleted widgets are forgotten once this many widgets were polished
+static const int initialPolishedWidgetsPruneSize = 1024;
+
+// Before Qt 5.7 the icon of an item view item is part of the fourth version of the option
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+typedef QStyleOptionViewItem ViewItemOption;
+#else
+typedef QStyleOptionViewItemV4 ViewItemOption;
+#endif
 
 ApplicationProxyStyle::ApplicationProxyStyle(QStyle *style) :
-    QProxyStyle(style)
+    QProxyStyle(style),
+    m_paintBudgetMonitor(new PaintBudgetMonitor(this)),
+    m_metricsCacheEnabled(false),
+    m_metricsGeneration(0),
+    m_metricsCacheHits(0),
+    m_metricsCacheMisses(0),
+    m_polishedWidgetsPruneSize(initialPolishedWidgetsPruneSize),
+    m_nextPolishedWidgetSerial(1),
+    m_tintedPixmapPruneSize(maximumTintedPixmapCacheSize),
+    m_tintedIconPruneSize(maximumTintedPixmapCacheSize)
+{
+}
+
+/*!
+ * \brief ApplicationProxyStyle::paintBudgetMonitor
+ *        Monitor that switches styled subtrees to a cheaper style if they paint too slowly
+ */
+PaintBudgetMonitor *ApplicationProxyStyle::paintBudgetMonitor() const
+{
+    return m_paintBudgetMonitor;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::setMetricsCacheEnabled
+ *        Remember the results of pixelMetric, styleHint, sizeFromContents and subElementRect
+ *        until the next call of invalidateMetricsCache
+ */
+void ApplicationProxyStyle::setMetricsCacheEnabled(bool enabled)
+{
+    m_metricsCacheEnabled = enabled;
+    invalidateMetricsCache();
+}
+
+bool ApplicationProxyStyle::isMetricsCacheEnabled() const
+{
+    return m_metricsCacheEnabled;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::invalidateMetricsCache
+ *        Forget all cached metrics. Must be called whenever the style of the application changes.
+ */
+void ApplicationProxyStyle::invalidateMetricsCache()
+{
+    ++m_metricsGeneration;
+    m_intMetricsCache.clear();
+    m_sizeMetricsCache.clear();
+    m_rectMetricsCache.clear();
+}
+
+quint64 ApplicationProxyStyle::metricsCacheHits() const
+{
+    return m_metricsCacheHits;
+}
+
+quint64 ApplicationProxyStyle::metricsCacheMisses() const
+{
+    return m_metricsCacheMisses;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::setIconTint
+ *        Recolor all icons drawn by the style. A null tint leaves the icons untouched.
+ */
+void ApplicationProxyStyle::setIconTint(const IconTint &iconTint)
+{
+    if (iconTint.cacheKey() == m_iconTint.cacheKey())
+        return;
+
+    m_iconTint = iconTint;
+    m_tintedPixmapCache.clear();
+    m_tintedPixmapKeys.clear();
+    m_tintedIconCache.clear();
+    m_tintedIconKeys.clear();
+
+    // Icons keep their generated pixmaps in the pixmap cache
+    QPixmapCache::clear();
+    foreach (QWidget *topLevelWidget, QApplication::topLevelWidgets())
+        topLevelWidget->update();
+}
+
+IconTint ApplicationProxyStyle::iconTint() const
+{
+    return m_iconTint;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::tintedPixmap
+ *        Get the pixmap recolored with the icon tint of the style. The result is cached, so
+ *        only the first request of a pixmap recolors it.
+ */
+QPixmap ApplicationProxyStyle::tintedPixmap(const QPixmap &pixmap, QIcon::Mode mode) const
+{
+    if (m_iconTint.isNull() || pixmap.isNull())
+        return pixmap;
+
+    // Don't tint pixmaps twice. Tinted pixmaps stay known as long as someone else holds them.
+    if (m_tintedPixmapKeys.contains(pixmap.cacheKey()))
+        return pixmap;
+
+    TintedPixmapKey key;
+    key.pixmapKey = pixmap.cacheKey();
+    key.size = pixmap.size();
+    key.devicePixelRatio = pixmap.devicePixelRatio();
+    key.mode = mode;
+    key.tintKey = m_iconTint.cacheKey();
+
+    QHash<TintedPixmapKey, QPixmap>::const_iterator cached = m_tintedPixmapCache.constFind(key);
+    if (cached != m_tintedPixmapCache.constEnd())
+        return cached.value();
+
+    QImage image = pixmap.toImage();
+    m_iconTint.apply(&image);
+    QPixmap tinted = QPixmap::fromImage(image);
+    tinted.setDevicePixelRatio(pixmap.devicePixelRatio());
+
+    if (m_tintedPixmapCache.size() >= m_tintedPixmapPruneSize)
+        pruneTintedPixmaps();
+    m_tintedPixmapCache.insert(key, tinted);
+    m_tintedPixmapKeys.insert(tinted.cacheKey());
+
+    return tinted;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::pruneTintedPixmaps
+ *        Forget the tinted pixmaps nobody else holds anymore. Pixmaps that are still held, e.g.
+ *        by a tinted icon, stay known, so they are never tinted again.
+ */
+void ApplicationProxyStyle::pruneTintedPixmaps() const
+{
+    QHash<TintedPixmapKey, QPixmap>::iterator it = m_tintedPixmapCache.begin();
+    while (it != m_tintedPixmapCache.end()) {
+        if (it.value().isDetached()) {
+            m_tintedPixmapKeys.remove(it.value().cacheKey());
+            it = m_tintedPixmapCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_tintedPixmapPruneSize = qMax(maximumTintedPixmapCacheSize, m_tintedPixmapCache.size() * 2);
+}
+
+void ApplicationProxyStyle::pruneTintedIcons() const
+{
+    QHash<TintedIconKey, QIcon>::iterator it = m_tintedIconCache.begin();
+    while (it != m_tintedIconCache.end()) {
+        if (it.value().isDetached()) {
+            m_tintedIconKeys.remove(it.value().cacheKey());
+            it = m_tintedIconCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_tintedIconPruneSize = qMax(maximumTintedPixmapCacheSize, m_tintedIconCache.size() * 2);
+}
+
+/*!
+ * \brief ApplicationProxyStyle::addIconTintRoot
+ *        Tint the icons of the widget and its children. Icons outside of the roots keep their
+ *        colors, because the tint is made for the background of the styled widgets only.
+ */
+void ApplicationProxyStyle::addIconTintRoot(QWidget *root)
+{
+    m_iconTintRoots.insert(root, QPointer<QWidget>(root));
+}
+
+void ApplicationProxyStyle::clearIconTintRoots()
 {
+    m_iconTintRoots.clear();
+}
+
+bool ApplicationProxyStyle::isInIconTintRoot(const QWidget *widget) const
+{
+    if (m_iconTintRoots.isEmpty())
+        return false;
+
+    for (const QWidget *ancestor = widget; ancestor; ancestor = ancestor->parentWidget()) {
+        QHash<const QWidget *, QPointer<QWidget> >::const_iterator root = m_iconTintRoots.constFind(ancestor);
+        if (root != m_iconTintRoots.constEnd() && root.value().data() == ancestor)
+            return true;
+    }
+
+    return false;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::setThemeMapping
+ *        Report widgets that match the theme mapping with themeTargetPolished when they are
+ *        polished, so widgets created after the style was applied get it as well
+ */
+void ApplicationProxyStyle::setThemeMapping(const ThemeMapping &themeMapping)
+{
+    m_themeMapping = themeMapping;
+}
+
+void ApplicationProxyStyle::clearThemeMapping()
+{
+    m_themeMapping = ThemeMapping();
+    m_polishedThemeTargets.clear();
 }
 
 void ApplicationProxyStyle::polish(QWidget *widget)
 {
-    Q_UNUSED(widget);
+    m_paintBudgetMonitor->widgetPolished(widget);
+    rememberPolishedWidget(widget);
+
+    if (m_themeMapping.isEmpty())
+        return;
+
+    // Setting a stylesheet polishes the widget again, so it can't be done from here
+    const int targetKind = m_themeMapping.targetKind(widget);
+    if (targetKind >= 0) {
+        if (m_polishedThemeTargets.isEmpty())
+            QMetaObject::invokeMethod(this, "emitPolishedThemeTargets", Qt::QueuedConnection);
+        m_polishedThemeTargets.append(qMakePair(QPointer<QWidget>(widget), targetKind));
+    }
+}
+
+void ApplicationProxyStyle::emitPolishedThemeTargets()
+{
+    const QList<QPair<QPointer<QWidget>, int> > polishedThemeTargets = m_polishedThemeTargets;
+    m_polishedThemeTargets.clear();
+
+    for (int i = 0; i < polishedThemeTargets.count(); ++i) {
+        if (QWidget *widget = polishedThemeTargets.at(i).first.data())
+            emit themeTargetPolished(widget, polishedThemeTargets.at(i).second);
+    }
 }
 
 void ApplicationProxyStyle::drawPrimitive(QStyle::PrimitiveElement element, const QStyleOption *option,
@@ -26,3 +271,491 @@ void ApplicationProxyStyle::drawPrimitive(QStyle::PrimitiveElement element, cons
 {
     QProxyStyle::drawPrimitive(element, option, painter, widget);
 }
+
+int ApplicationProxyStyle::pixelMetric(QStyle::PixelMetric metric, const QStyleOption *option,
+                                       const QWidget *widget) const
+{
+    MetricsKey key;
+    if (!metricsKey(PixelMetricQuery, metric, option, widget, QSize(), &key))
+        return QProxyStyle::pixelMetric(metric, option, widget);
+
+    QHash<MetricsKey, int>::const_iterator cached = m_intMetricsCache.constFind(key);
+    if (cached != m_intMetricsCache.constEnd()) {
+        ++m_metricsCacheHits;
+        return cached.value();
+    }
+
+    ++m_metricsCacheMisses;
+    const int value = QProxyStyle::pixelMetric(metric, option, widget);
+    if (m_intMetricsCache.size() >= maximumMetricsCacheSize)
+        m_intMetricsCache.clear();
+    m_intMetricsCache.insert(key, value);
+    return value;
+}
+
+int ApplicationProxyStyle::styleHint(QStyle::StyleHint hint, const QStyleOption *option,
+                                     const QWidget *widget, QStyleHintReturn *returnData) const
+{
+    // The return data is filled by the style, so it can't be cached
+    MetricsKey key;
+    if (returnData || !metricsKey(StyleHintQuery, hint, option, widget, QSize(), &key))
+        return QProxyStyle::styleHint(hint, option, widget, returnData);
+
+    QHash<MetricsKey, int>::const_iterator cached = m_intMetricsCache.constFind(key);
+    if (cached != m_intMetricsCache.constEnd()) {
+        ++m_metricsCacheHits;
+        return cached.value();
+    }
+
+    ++m_metricsCacheMisses;
+    const int value = QProxyStyle::styleHint(hint, option, widget, returnData);
+    if (m_intMetricsCache.size() >= maximumMetricsCacheSize)
+        m_intMetricsCache.clear();
+    m_intMetricsCache.insert(key, value);
+    return value;
+}
+
+QSize ApplicationProxyStyle::sizeFromContents(QStyle::ContentsType type, const QStyleOption *option,
+                                              const QSize &size, const QWidget *widget) const
+{
+    MetricsKey key;
+    if (!metricsKey(SizeFromContentsQuery, type, option, widget, size, &key))
+        return QProxyStyle::sizeFromContents(type, option, size, widget);
+
+    QHash<MetricsKey, QSize>::const_iterator cached = m_sizeMetricsCache.constFind(key);
+    if (cached != m_sizeMetricsCache.constEnd()) {
+        ++m_metricsCacheHits;
+        return cached.value();
+    }
+
+    ++m_metricsCacheMisses;
+    const QSize value = QProxyStyle::sizeFromContents(type, option, size, widget);
+    if (m_sizeMetricsCache.size() >= maximumMetricsCacheSize)
+        m_sizeMetricsCache.clear();
+    m_sizeMetricsCache.insert(key, value);
+    return value;
+}
+
+QRect ApplicationProxyStyle::subElementRect(QStyle::SubElement element, const QStyleOption *option,
+                                            const QWidget *widget) const
+{
+    MetricsKey key;
+    if (!metricsKey(SubElementRectQuery, element, option, widget, QSize(), &key))
+        return QProxyStyle::subElementRect(element, option, widget);
+
+    QHash<MetricsKey, QRect>::const_iterator cached = m_rectMetricsCache.constFind(key);
+    if (cached != m_rectMetricsCache.constEnd()) {
+        ++m_metricsCacheHits;
+        return cached.value();
+    }
+
+    ++m_metricsCacheMisses;
+    const QRect value = QProxyStyle::subElementRect(element, option, widget);
+    if (m_rectMetricsCache.size() >= maximumMetricsCacheSize)
+        m_rectMetricsCache.clear();
+    m_rectMetricsCache.insert(key, value);
+    return value;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::drawControl
+ *        Replace the icon of the option with the tinted icon, if the widget is inside of one of
+ *        the icon tint roots. Icons are tinted before the base style picks the pixmap of a mode,
+ *        so normal, active, selected and disabled icons get the same colors.
+ */
+void ApplicationProxyStyle::drawControl(QStyle::ControlElement element, const QStyleOption *option,
+                                        QPainter *painter, const QWidget *widget) const
+{
+    if (m_iconTint.isNull() || !isInIconTintRoot(widget)) {
+        QProxyStyle::drawControl(element, option, painter, widget);
+        return;
+    }
+
+    switch (element) {
+    case CE_ToolButtonLabel:
+        if (const QStyleOptionToolButton *toolButton = qstyleoption_cast<const QStyleOptionToolButton *>(option)) {
+            QStyleOptionToolButton tintedOption(*toolButton);
+            tintedOption.icon = tintedIcon(toolButton->icon, toolButton->iconSize);
+            QProxyStyle::drawControl(element, &tintedOption, painter, widget);
+            return;
+        }
+        break;
+    case CE_PushButtonLabel:
+        if (const QStyleOptionButton *button = qstyleoption_cast<const QStyleOptionButton *>(option)) {
+            QStyleOptionButton tintedOption(*button);
+            tintedOption.icon = tintedIcon(button->icon, button->iconSize);
+            QProxyStyle::drawControl(element, &tintedOption, painter, widget);
+            return;
+        }
+        break;
+    case CE_ComboBoxLabel:
+        if (const QStyleOptionComboBox *comboBox = qstyleoption_cast<const QStyleOptionComboBox *>(option)) {
+            QStyleOptionComboBox tintedOption(*comboBox);
+            tintedOption.currentIcon = tintedIcon(comboBox->currentIcon, comboBox->iconSize);
+            QProxyStyle::drawControl(element, &tintedOption, painter, widget);
+            return;
+        }
+        break;
+    case CE_MenuItem:
+        if (const QStyleOptionMenuItem *menuItem = qstyleoption_cast<const QStyleOptionMenuItem *>(option)) {
+            const int iconExtent = pixelMetric(PM_SmallIconSize, option, widget);
+            QStyleOptionMenuItem tintedOption(*menuItem);
+            tintedOption.icon = tintedIcon(menuItem->icon, QSize(iconExtent, iconExtent));
+            QProxyStyle::drawControl(element, &tintedOption, painter, widget);
+            return;
+        }
+        break;
+    case CE_HeaderLabel:
+        if (const QStyleOptionHeader *header = qstyleoption_cast<const QStyleOptionHeader *>(option)) {
+            const int iconExtent = pixelMetric(PM_SmallIconSize, option, widget);
+            QStyleOptionHeader tintedOption(*header);
+            tintedOption.icon = tintedIcon(header->icon, QSize(iconExtent, iconExtent));
+            QProxyStyle::drawControl(element, &tintedOption, painter, widget);
+            return;
+        }
+        break;
+    case CE_ItemViewItem:
+        if (const ViewItemOption *viewItem = qstyleoption_cast<const ViewItemOption *>(option)) {
+            ViewItemOption tintedOption(*viewItem);
+            tintedOption.icon = tintedIcon(viewItem->icon, viewItem->decorationSize);
+            QProxyStyle::drawControl(element, &tintedOption, painter, widget);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+/*!
+ * \brief ApplicationProxyStyle::tintedIcon
+ *        Icon with the tinted normal pixmaps of the icon in the size. The other modes are
+ *        generated from them. The icon is cached, because styles like Qt Creator's cache their
+ *        own pixmaps by the key of the icon.
+ */
+QIcon ApplicationProxyStyle::tintedIcon(const QIcon &icon, const QSize &size) const
+{
+    if (icon.isNull() || !size.isValid() || m_tintedIconKeys.contains(icon.cacheKey()))
+        return icon;
+
+    TintedIconKey key;
+    key.iconKey = icon.cacheKey();
+    key.size = size;
+    // QIcon::pixmap picks the pixmap for the device pixel ratio of the application
+    key.devicePixelRatio = qApp->devicePixelRatio();
+
+    QHash<TintedIconKey, QIcon>::const_iterator cached = m_tintedIconCache.constFind(key);
+    if (cached != m_tintedIconCache.constEnd())
+        return cached.value();
+
+    QIcon tinted;
+    tinted.addPixmap(tintedPixmap(icon.pixmap(size, QIcon::Normal, QIcon::Off), QIcon::Normal),
+                     QIcon::Normal, QIcon::Off);
+    tinted.addPixmap(tintedPixmap(icon.pixmap(size, QIcon::Normal, QIcon::On), QIcon::Normal),
+                     QIcon::Normal, QIcon::On);
+
+    if (m_tintedIconCache.size() >= m_tintedIconPruneSize)
+        pruneTintedIcons();
+    m_tintedIconCache.insert(key, tinted);
+    m_tintedIconKeys.insert(tinted.cacheKey());
+
+    return tinted;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::metricsKey
+ *        Build the cache key of a metrics query from the widget and the parts of the option that
+ *        influence the result. Returns false if the result can't be cached, because the cache is
+ *        disabled, the widget wasn't polished yet, the query depends on a widget that wasn't
+ *        given or the option type has content that isn't part of the key.
+ */
+bool ApplicationProxyStyle::metricsKey(MetricsQuery query, int element, const QStyleOption *option,
+                                       const QWidget *widget, const QSize &size, MetricsKey *key) const
+{
+    if (!m_metricsCacheEnabled)
+        return false;
+
+    key->query = query;
+    key->element = element;
+    key->widget = widget;
+    key->widgetSerial = 0;
+    key->optionType = -1;
+    key->optionState = 0;
+    key->optionDirection = 0;
+    key->fontHeight = 0;
+    key->size = size;
+    key->iconKey = 0;
+    for (int i = 0; i < MetricsOptionFieldCount; ++i)
+        key->optionFields[i] = 0;
+    key->generation = m_metricsGeneration;
+
+    // Base styles read the state of the widget, e.g. its properties, attributes or icon size.
+    // So results are cached per polished widget, and the serial keeps a widget that reuses the
+    // address of a deleted one from getting its results. Without a widget only queries that
+    // don't depend on one are cached.
+    if (widget) {
+        QHash<const QWidget *, PolishedWidget>::const_iterator polished = m_polishedWidgets.constFind(widget);
+        if (polished == m_polishedWidgets.constEnd() || polished.value().widget.data() != widget)
+            return false;
+        key->widgetSerial = polished.value().serial;
+    } else if (!isWidgetIndependent(query, element)) {
+        return false;
+    }
+
+    if (!option)
+        return true;
+
+    key->optionType = option->type;
+    key->optionState = int(option->state);
+    key->optionDirection = option->direction;
+    key->fontHeight = option->fontMetrics.height();
+    key->rect = option->rect;
+
+    int *fields = key->optionFields;
+    switch (option->type) {
+    case QStyleOption::SO_Default:
+    case QStyleOption::SO_FocusRect:
+        break;
+    case QStyleOption::SO_Frame:
+        if (const QStyleOptionFrame *frame = qstyleoption_cast<const QStyleOptionFrame *>(option)) {
+            fields[0] = frame->lineWidth;
+            fields[1] = frame->midLineWidth;
+        }
+        // Before Qt 5.7 the features are part of the second version of the option
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+        if (const QStyleOptionFrame *frame = qstyleoption_cast<const QStyleOptionFrame *>(option))
+#else
+        if (const QStyleOptionFrameV2 *frame = qstyleoption_cast<const QStyleOptionFrameV2 *>(option))
+#endif
+            fields[2] = int(frame->features);
+        break;
+    case QStyleOption::SO_Button:
+        if (const QStyleOptionButton *button = qstyleoption_cast<const QStyleOptionButton *>(option)) {
+            key->text = button->text;
+            key->iconKey = button->icon.cacheKey();
+            key->iconSize = button->iconSize;
+            fields[0] = int(button->features);
+        }
+        break;
+    case QStyleOption::SO_ToolButton:
+        if (const QStyleOptionToolButton *toolButton = qstyleoption_cast<const QStyleOptionToolButton *>(option)) {
+            key->text = toolButton->text;
+            key->iconKey = toolButton->icon.cacheKey();
+            key->iconSize = toolButton->iconSize;
+            fields[0] = int(toolButton->features);
+            fields[1] = int(toolButton->toolButtonStyle);
+            fields[2] = int(toolButton->arrowType);
+            fields[3] = int(toolButton->subControls);
+        }
+        break;
+    case QStyleOption::SO_ComboBox:
+        if (const QStyleOptionComboBox *comboBox = qstyleoption_cast<const QStyleOptionComboBox *>(option)) {
+            key->text = comboBox->currentText;
+            key->iconKey = comboBox->currentIcon.cacheKey();
+            key->iconSize = comboBox->iconSize;
+            fields[0] = int(comboBox->editable);
+            fields[1] = int(comboBox->frame);
+            fields[2] = int(comboBox->subControls);
+        }
+        break;
+    case QStyleOption::SO_Tab:
+        if (const QStyleOptionTab *tab = qstyleoption_cast<const QStyleOptionTab *>(option)) {
+            key->text = tab->text;
+            key->iconKey = tab->icon.cacheKey();
+            fields[0] = int(tab->shape);
+            fields[1] = int(tab->position);
+            fields[2] = int(tab->selectedPosition);
+            fields[3] = int(tab->cornerWidgets);
+            fields[4] = int(tab->row);
+        }
+        // Before Qt 5.7 the icon and button sizes are part of the third version of the option
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+        if (const QStyleOptionTab *tab = qstyleoption_cast<const QStyleOptionTab *>(option)) {
+#else
+        if (const QStyleOptionTabV3 *tab = qstyleoption_cast<const QStyleOptionTabV3 *>(option)) {
+#endif
+            key->iconSize = tab->iconSize;
+            key->leftButtonSize = tab->leftButtonSize;
+            key->rightButtonSize = tab->rightButtonSize;
+            fields[5] = int(tab->documentMode);
+        }
+        break;
+    case QStyleOption::SO_Header:
+        if (const QStyleOptionHeader *header = qstyleoption_cast<const QStyleOptionHeader *>(option)) {
+            key->text = header->text;
+            key->iconKey = header->icon.cacheKey();
+            fields[0] = header->section;
+            fields[1] = int(header->position);
+            fields[2] = int(header->sortIndicator);
+            fields[3] = int(header->orientation);
+            fields[4] = int(header->textAlignment);
+            fields[5] = int(header->iconAlignment);
+            fields[6] = int(header->selectedPosition);
+        }
+        break;
+    case QStyleOption::SO_MenuItem:
+        if (const QStyleOptionMenuItem *menuItem = qstyleoption_cast<const QStyleOptionMenuItem *>(option)) {
+            key->text = menuItem->text;
+            key->iconKey = menuItem->icon.cacheKey();
+            fields[0] = int(menuItem->menuItemType);
+            fields[1] = int(menuItem->checkType);
+            fields[2] = menuItem->maxIconWidth;
+            fields[3] = menuItem->tabWidth;
+            fields[4] = int(menuItem->checked);
+            fields[5] = menuItem->font.pointSize();
+            fields[6] = menuItem->font.pixelSize();
+            fields[7] = menuItem->font.weight();
+            fields[8] = int(menuItem->font.italic());
+            fields[9] = int(menuItem->menuHasCheckableItems);
+            key->fontFamily = menuItem->font.family();
+        }
+        break;
+    default:
+        // Item views, sliders, spin boxes etc. carry more state than the key covers
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief ApplicationProxyStyle::rememberPolishedWidget
+ *        Give the widget a new serial for the metrics cache keys. A widget is polished again
+ *        when its style changes, so its cached results are dropped then as well.
+ */
+void ApplicationProxyStyle::rememberPolishedWidget(QWidget *widget)
+{
+    PolishedWidget polished;
+    polished.widget = widget;
+    polished.serial = m_nextPolishedWidgetSerial++;
+    m_polishedWidgets.insert(widget, polished);
+
+    if (m_polishedWidgets.size() < m_polishedWidgetsPruneSize)
+        return;
+
+    QHash<const QWidget *, PolishedWidget>::iterator it = m_polishedWidgets.begin();
+    while (it != m_polishedWidgets.end()) {
+        if (it.value().widget.isNull())
+            it = m_polishedWidgets.erase(it);
+        else
+            ++it;
+    }
+    m_polishedWidgetsPruneSize = qMax(initialPolishedWidgetsPruneSize, m_polishedWidgets.size() * 2);
+}
+
+/*!
+ * \brief ApplicationProxyStyle::isWidgetIndependent
+ *        Queries that base styles answer without looking at a widget, so they can be cached
+ *        when they are made without one
+ */
+bool ApplicationProxyStyle::isWidgetIndependent(MetricsQuery query, int element)
+{
+    if (query != PixelMetricQuery)
+        return false;
+
+    switch (element) {
+    case PM_SmallIconSize:
+    case PM_LargeIconSize:
+    case PM_ToolBarIconSize:
+    case PM_ButtonIconSize:
+    case PM_ListViewIconSize:
+    case PM_IconViewIconSize:
+    case PM_TabBarIconSize:
+    case PM_MessageBoxIconSize:
+    case PM_LayoutLeftMargin:
+    case PM_LayoutTopMargin:
+    case PM_LayoutRightMargin:
+    case PM_LayoutBottomMargin:
+    case PM_LayoutHorizontalSpacing:
+    case PM_LayoutVerticalSpacing:
+    case PM_DefaultFrameWidth:
+    case PM_ScrollBarExtent:
+    case PM_IndicatorWidth:
+    case PM_IndicatorHeight:
+    case PM_ExclusiveIndicatorWidth:
+    case PM_ExclusiveIndicatorHeight:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ApplicationProxyStyle::MetricsKey::operator==(const MetricsKey &other) const
+{
+    if (query != other.query
+            || element != other.element
+            || widget != other.widget
+            || widgetSerial != other.widgetSerial
+            || optionType != other.optionType
+            || optionState != other.optionState
+            || optionDirection != other.optionDirection
+            || fontHeight != other.fontHeight
+            || rect != other.rect
+            || size != other.size
+            || iconKey != other.iconKey
+            || iconSize != other.iconSize
+            || leftButtonSize != other.leftButtonSize
+            || rightButtonSize != other.rightButtonSize
+            || generation != other.generation) {
+        return false;
+    }
+
+    for (int i = 0; i < MetricsOptionFieldCount; ++i) {
+        if (optionFields[i] != other.optionFields[i])
+            return false;
+    }
+
+    return text == other.text && fontFamily == other.fontFamily;
+}
+
+uint qHash(const ApplicationProxyStyle::MetricsKey &key, uint seed)
+{
+    uint hash = seed ^ uint(key.query) ^ (uint(key.element) << 3);
+    hash = hash * 31 + qHash(key.widget);
+    hash = hash * 31 + uint(key.widgetSerial);
+    hash = hash * 31 + uint(key.optionType);
+    hash = hash * 31 + uint(key.optionState);
+    hash = hash * 31 + uint(key.fontHeight);
+    hash = hash * 31 + uint(key.rect.x()) + (uint(key.rect.y()) << 16);
+    hash = hash * 31 + uint(key.rect.width()) + (uint(key.rect.height()) << 16);
+    hash = hash * 31 + uint(key.size.width()) + (uint(key.size.height()) << 16);
+    hash = hash * 31 + qHash(key.text);
+    hash = hash * 31 + qHash(key.iconKey);
+    hash = hash * 31 + uint(key.iconSize.width()) + (uint(key.iconSize.height()) << 16);
+    for (int i = 0; i < ApplicationProxyStyle::MetricsOptionFieldCount; ++i)
+        hash = hash * 31 + uint(key.optionFields[i]);
+    return hash ^ uint(key.generation);
+}
+
+bool ApplicationProxyStyle::TintedPixmapKey::operator==(const TintedPixmapKey &other) const
+{
+    return pixmapKey == other.pixmapKey
+            && size == other.size
+            && qFuzzyCompare(devicePixelRatio, other.devicePixelRatio)
+            && mode == other.mode
+            && tintKey == other.tintKey;
+}
+
+uint qHash(const ApplicationProxyStyle::TintedPixmapKey &key, uint seed)
+{
+    uint hash = seed ^ qHash(key.pixmapKey) ^ (uint(key.mode) << 24);
+    hash = hash * 31 + uint(key.size.width()) + (uint(key.size.height()) << 16);
+    hash = hash * 31 + uint(qRound(key.devicePixelRatio * 100));
+    return hash ^ qHash(key.tintKey);
+}
+
+bool ApplicationProxyStyle::TintedIconKey::operator==(const TintedIconKey &other) const
+{
+    return iconKey == other.iconKey
+            && size == other.size
+            && qFuzzyCompare(devicePixelRatio, other.devicePixelRatio);
+}
+
+uint qHash(const ApplicationProxyStyle::TintedIconKey &key, uint seed)
+{
+    uint hash = seed ^ qHash(key.iconKey);
+    hash = hash * 31 + uint(key.size.width()) + (uint(key.size.height()) << 16);
+    return hash * 31 + uint(qRound(key.devicePixelRatio * 100));
+}
@@ -9,7 +9,23 @@
 #ifndef APPLICATIONPROXYSTYLE_H
 #define APPLICATIONPROXYSTYLE_H
 
+#include <QHash>
+#include <QIcon>
+#include <QList>
+#include <QPair>
+#include <QPointer>
 #include <QProxyStyle>
+#include <QRect>
+#include <QSet>
+
+#include "icontint.h"
+#include "thememapping.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+class PaintBudgetMonitor;
+}
+}
 
 class ApplicationProxyStyle : public QProxyStyle
 {
@@ -17,8 +33,135 @@ class ApplicationProxyStyle : public QProxyStyle
 public:
     explicit ApplicationProxyStyle(QStyle *style);
 
+    CreatorStyleEdit::Internal::PaintBudgetMonitor *paintBudgetMonitor() const;
+
+    void setMetricsCacheEnabled(bool enabled);
+    bool isMetricsCacheEnabled() const;
+    void invalidateMetricsCache();
+    quint64 metricsCacheHits() const;
+    quint64 metricsCacheMisses() const;
+
+    void setIconTint(const CreatorStyleEdit::Internal::IconTint &iconTint);
+    CreatorStyleEdit::Internal::IconTint iconTint() const;
+    QPixmap tintedPixmap(const QPixmap &pixmap, QIcon::Mode mode) const;
+    void addIconTintRoot(QWidget *root);
+    void clearIconTintRoots();
+
+    void setThemeMapping(const CreatorStyleEdit::Internal::ThemeMapping &themeMapping);
+    void clearThemeMapping();
+
     void polish(QWidget *widget);
     void drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget = 0) const;
+
+    int pixelMetric(PixelMetric metric, const QStyleOption *option = 0, const QWidget *widget = 0) const;
+    int styleHint(StyleHint hint, const QStyleOption *option = 0, const QWidget *widget = 0,
+                  QStyleHintReturn *returnData = 0) const;
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option, const QSize &size,
+                           const QWidget *widget) const;
+    QRect subElementRect(SubElement element, const QStyleOption *option, const QWidget *widget) const;
+
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                     const QWidget *widget = 0) const;
+
+signals:
+    void themeTargetPolished(QWidget *widget, int targetKind);
+
+private slots:
+    void emitPolishedThemeTargets();
+
+private:
+    enum MetricsQuery {
+        PixelMetricQuery,
+        StyleHintQuery,
+        SizeFromContentsQuery,
+        SubElementRectQuery
+    };
+
+    enum { MetricsOptionFieldCount = 10 };
+
+    struct MetricsKey {
+        MetricsQuery query;
+        int element;
+        const QWidget *widget;
+        quint64 widgetSerial;
+        int optionType;
+        int optionState;
+        int optionDirection;
+        int fontHeight;
+        QRect rect;
+        QSize size;
+        // Content of the option subclass
+        QString text;
+        QString fontFamily;
+        qint64 iconKey;
+        QSize iconSize;
+        QSize leftButtonSize;
+        QSize rightButtonSize;
+        int optionFields[MetricsOptionFieldCount];
+        quint64 generation;
+
+        bool operator==(const MetricsKey &other) const;
+    };
+
+    friend uint qHash(const MetricsKey &key, uint seed);
+
+    struct TintedPixmapKey {
+        qint64 pixmapKey;
+        QSize size;
+        qreal devicePixelRatio;
+        QIcon::Mode mode;
+        quint64 tintKey;
+
+        bool operator==(const TintedPixmapKey &other) const;
+    };
+
+    friend uint qHash(const TintedPixmapKey &key, uint seed);
+
+    struct TintedIconKey {
+        qint64 iconKey;
+        QSize size;
+        qreal devicePixelRatio;
+
+        bool operator==(const TintedIconKey &other) const;
+    };
+
+    friend uint qHash(const TintedIconKey &key, uint seed);
+
+    struct PolishedWidget {
+        QPointer<QWidget> widget;
+        quint64 serial;
+    };
+
+    bool metricsKey(MetricsQuery query, int element, const QStyleOption *option,
+                    const QWidget *widget, const QSize &size, MetricsKey *key) const;
+    void rememberPolishedWidget(QWidget *widget);
+    static bool isWidgetIndependent(MetricsQuery query, int element);
+    QIcon tintedIcon(const QIcon &icon, const QSize &size) const;
+    bool isInIconTintRoot(const QWidget *widget) const;
+    void pruneTintedPixmaps() const;
+    void pruneTintedIcons() const;
+
+    CreatorStyleEdit::Internal::PaintBudgetMonitor *m_paintBudgetMonitor;
+    bool m_metricsCacheEnabled;
+    quint64 m_metricsGeneration;
+    mutable quint64 m_metricsCacheHits;
+    mutable quint64 m_metricsCacheMisses;
+    mutable QHash<MetricsKey, int> m_intMetricsCache;
+    mutable QHash<MetricsKey, QSize> m_sizeMetricsCache;
+    mutable QHash<MetricsKey, QRect> m_rectMetricsCache;
+    QHash<const QWidget *, PolishedWidget> m_polishedWidgets;
+    int m_polishedWidgetsPruneSize;
+    quint64 m_nextPolishedWidgetSerial;
+    CreatorStyleEdit::Internal::IconTint m_iconTint;
+    mutable QHash<TintedPixmapKey, QPixmap> m_tintedPixmapCache;
+    mutable QSet<qint64> m_tintedPixmapKeys;
+    mutable int m_tintedPixmapPruneSize;
+    mutable QHash<TintedIconKey, QIcon> m_tintedIconCache;
+    mutable QSet<qint64> m_tintedIconKeys;
+    mutable int m_tintedIconPruneSize;
+    QHash<const QWidget *, QPointer<QWidget> > m_iconTintRoots;
+    CreatorStyleEdit::Internal::ThemeMapping m_themeMapping;
+    QList<QPair<QPointer<QWidget>, int> > m_polishedThemeTargets;
 };
 
 #endif // APPLICATIONPROXYSTYLE_H
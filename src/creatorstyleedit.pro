@@ -1,11 +1,25 @@
 DEFINES += CREATORSTYLEEDIT_LIBRARY
 
+QT += concurrent
+
 # CreatorStyleEdit files
 
 SOURCES += creatorstyleeditplugin.cpp \
     styleeditor.cpp \
     colorselectorwidget.cpp \
-    applicationproxystyle.cpp
+    applicationproxystyle.cpp \
+    icontint.cpp \
+    icontintbenchmark.cpp \
+    layoutbenchmark.cpp \
+    paintbudgetmonitor.cpp \
+    preparedstyle.cpp \
+    processmemory.cpp \
+    stylecatalog.cpp \
+    stylepipeline.cpp \
+    stylesoakrunner.cpp \
+    styletargetcollector.cpp \
+    thememapping.cpp \
+    widgetstylebackup.cpp
 
 HEADERS += creatorstyleeditplugin.h \
         creatorstyleedit_global.h \
@@ -13,8 +27,22 @@ HEADERS += creatorstyleeditplugin.h \
     styleeditor.h \
     colorselectorwidget.h \
     applicationproxystyle.h \
+    icontint.h \
+    icontintbenchmark.h \
+    layoutbenchmark.h \
+    paintbudgetmonitor.h \
+    preparedstyle.h \
+    processmemory.h \
+    stylecatalog.h \
+    stylepipeline.h \
+    stylesoakrunner.h \
+    styletargetcollector.h \
+    thememapping.h \
+    widgetstylebackup.h \
     defines.h
 
+win32: LIBS += -lpsapi
+
 # Qt Creator linking
 
 ## set the QTC_SOURCE environment variable to override the setting here
@@ -9,7 +9,14 @@
 #include "creatorstyleeditplugin.h"
 #include "creatorstyleeditconstants.h"
 #include "applicationproxystyle.h"
+#include "icontintbenchmark.h"
+#include "layoutbenchmark.h"
+#include "paintbudgetmonitor.h"
 #include "styleeditor.h"
+#include "stylesoakrunner.h"
+#include "processmemory.h"
+#include "stylepipeline.h"
+#include "styletargetcollector.h"
 
 #include <utils/stylehelper.h>
 #include <coreplugin/icore.h>
@@ -17,7 +24,6 @@
 #include <coreplugin/actionmanager/command.h>
 #include <coreplugin/actionmanager/actioncontainer.h>
 #include <coreplugin/coreconstants.h>
-#include <coreplugin/navigationwidget.h>
 #include <coreplugin/modemanager.h>
 #include <coreplugin/imode.h>
 #include <debugger/debuggerconstants.h>
@@ -29,6 +35,9 @@
 #include <QStatusBar>
 #include <QApplication>
 #include <QStyleFactory>
+#include <QDir>
+#include <QFileInfo>
+#include <QTimer>
 
 #include <QtPlugin>
 #include <QDebug>
@@ -39,7 +48,14 @@
 namespace CreatorStyleEdit {
 namespace Internal {
 
-static const QString pluginNameSettingsKey(QStringLiteral("CreatorStyleEdit"));
+static const QString soakCyclesArgument(QStringLiteral("-stylesoak"));
+static const QString soakStyleSheetArgument(QStringLiteral("-stylesoakcss"));
+static const QString soakReportArgument(QStringLiteral("-stylesoakreport"));
+static const QString soakMaximumMemoryArgument(QStringLiteral("-stylesoakmaxmemory"));
+static const QString soakMaximumSlowdownArgument(QStringLiteral("-stylesoakmaxslowdown"));
+static const QString soakMaximumWidgetGrowthArgument(QStringLiteral("-stylesoakmaxwidgets"));
+static const QString layoutBenchmarkArgument(QStringLiteral("-stylelayoutbench"));
+static const QString iconTintBenchmarkArgument(QStringLiteral("-styleiconbench"));
 
 } // namespace Internal
 } // namespace CreatorStyleEdit
@@ -47,7 +63,14 @@ static const QString pluginNameSettingsKey(QStringLiteral("CreatorStyleEdit"));
 using namespace CreatorStyleEdit::Internal;
 
 CreatorStyleEditPlugin::CreatorStyleEditPlugin()
-    : m_styleEditor(0)
+    : m_styleEditor(0),
+      m_applicationStyle(0),
+      m_stylePipeline(0),
+      m_soakRunner(0),
+      m_layoutBenchmarkIterations(0),
+      m_iconTintBenchmarkIcons(0),
+      m_themeMapping(StyleTargetCollector::themeMapping()),
+      m_lateThemedWidgetCount(0)
 {
 }
 
@@ -57,7 +80,6 @@ CreatorStyleEditPlugin::~CreatorStyleEditPlugin()
 
 bool CreatorStyleEditPlugin::initialize(const QStringList &arguments, QString *errorString)
 {
-    Q_UNUSED(arguments)
     Q_UNUSED(errorString)
 
     m_styleEditor = new StyleEditor;
@@ -68,6 +90,13 @@ bool CreatorStyleEditPlugin::initialize(const QStringList &arguments, QString *e
     connect(m_styleEditor, &StyleEditor::styleNameChanged,
             this, &CreatorStyleEditPlugin::styleNameChanged);
 
+    m_stylePipeline = new StylePipeline(this);
+    m_stylePipeline->setCommitFunction([this](const PreparedStyle &style) {
+        commitStylesheet(style);
+    });
+
+    parseArguments(arguments);
+
     QAction *action = new QAction(tr("Edit Style"), this);
     Core::Command *cmd = Core::ActionManager::registerAction(action, Constants::ACTION_ID,
                                                              Core::Context(Core::Constants::C_GLOBAL));
@@ -86,37 +115,25 @@ bool CreatorStyleEditPlugin::delayedInitialize()
 {
     QStyle *applicationStyle = qApp->style();
 
-    ApplicationProxyStyle *style = new ApplicationProxyStyle(applicationStyle);
-    qApp->setStyle(style);
+    m_applicationStyle = new ApplicationProxyStyle(applicationStyle);
+    qApp->setStyle(m_applicationStyle);
+    connect(m_applicationStyle, &ApplicationProxyStyle::themeTargetPolished,
+            this, &CreatorStyleEditPlugin::themeTargetPolished);
+
+    QSettings *settings = Core::ICore::settings();
+    m_applicationStyle->paintBudgetMonitor()->setBudget(
+                settings->value(settingsKey(paintBudgetSettingsKey), 0).toInt());
+    m_applicationStyle->setMetricsCacheEnabled(
+                settings->value(settingsKey(metricsCacheSettingsKey), false).toBool());
 
     connect(Core::ModeManager::instance(), SIGNAL(currentModeChanged(Core::IMode*)),
             this, SLOT(modeChanged(Core::IMode*)));
 
-    // Give the main stacked widget of the OutputPaneManager a object name for better styling through
-    // stylesheet.
-    // This code assumes that the OutputPaneManager widget has only one direct child QStackedWidget,
-    // which is the desired output widget. This can also be accomplished by a patch of Qt Creator
-    // which sets the object name directly.
-    QWidget *outputPaneManagerWidget = widgetForClass(QStringLiteral("Core::Internal::OutputPaneManager"));
-    if (outputPaneManagerWidget) {
-        foreach (QObject *childObject, outputPaneManagerWidget->children()) {
-            if (!childObject->isWidgetType())
-                continue;
-
-            QWidget *childWidget = qobject_cast<QWidget *>(childObject);
-            if (!childWidget)
-                continue;
-
-            QString widgetClassName = QString::fromUtf8(childWidget->metaObject()->className());
-
-            if (widgetClassName  == QStringLiteral("QStackedWidget")) {
-                childWidget->setObjectName(QStringLiteral("OutputPaneManagerMainWidget"));
-            }
-        }
-    }
-
     stylesheetChanged();
 
+    if (m_soakRunner || m_layoutBenchmarkIterations > 0 || m_iconTintBenchmarkIcons > 0)
+        QTimer::singleShot(0, this, SLOT(runDiagnostics()));
+
     return true;
 }
 
@@ -129,24 +146,104 @@ ExtensionSystem::IPlugin::ShutdownFlag CreatorStyleEditPlugin::aboutToShutdown()
     return SynchronousShutdown;
 }
 
-void CreatorStyleEditPlugin::setStylesheetOnChildWidgetsWithClass(QWidget *widget,
-                                                                  const QString &stylesheet,
-                                                                  const QString &className)
+/*!
+ * \brief CreatorStyleEditPlugin::parseArguments
+ *        Set up the style soak test and the benchmarks if they were requested on the command line
+ */
+void CreatorStyleEditPlugin::parseArguments(const QStringList &arguments)
 {
-    foreach (QObject *childObject, widget->children()) {
-        if (!childObject->isWidgetType())
-            continue;
+    QStringList soakStyleSheetPaths;
+    qint64 soakMaximumMemory = -1;
+    int soakMaximumSlowdown = -1;
+    int soakMaximumWidgetGrowth = -1;
+    int soakCycles = 0;
+
+    for (int i = 0; i < arguments.count() - 1; ++i) {
+        const QString &argument = arguments.at(i);
+        const QString &value = arguments.at(i + 1);
+
+        if (argument == soakCyclesArgument) {
+            soakCycles = value.toInt();
+        } else if (argument == soakStyleSheetArgument) {
+            QFileInfo styleSheetInfo(value);
+            if (styleSheetInfo.isDir()) {
+                QDir styleSheetDir(value);
+                foreach (const QFileInfo fileInfo,
+                         styleSheetDir.entryInfoList(QStringList(QStringLiteral("*.css")), QDir::Files)) {
+                    soakStyleSheetPaths.append(fileInfo.absoluteFilePath());
+                }
+            } else {
+                soakStyleSheetPaths.append(styleSheetInfo.absoluteFilePath());
+            }
+        } else if (argument == soakReportArgument) {
+            m_soakReportPath = value;
+        } else if (argument == soakMaximumMemoryArgument) {
+            soakMaximumMemory = value.toLongLong() * 1024;
+        } else if (argument == soakMaximumSlowdownArgument) {
+            soakMaximumSlowdown = value.toInt();
+        } else if (argument == soakMaximumWidgetGrowthArgument) {
+            soakMaximumWidgetGrowth = value.toInt();
+        } else if (argument == layoutBenchmarkArgument) {
+            m_layoutBenchmarkIterations = value.toInt();
+        } else if (argument == iconTintBenchmarkArgument) {
+            m_iconTintBenchmarkIcons = value.toInt();
+        }
+    }
+
+    if (soakCycles <= 0)
+        return;
+
+    m_soakRunner = new StyleSoakRunner(m_styleEditor, m_stylePipeline, this);
+    m_soakRunner->setCycles(soakCycles);
+    m_soakRunner->setCustomStyleSheetPaths(soakStyleSheetPaths);
+    if (soakMaximumMemory >= 0)
+        m_soakRunner->setMaximumMemoryGrowth(soakMaximumMemory);
+    if (soakMaximumSlowdown >= 0)
+        m_soakRunner->setMaximumSlowdown(soakMaximumSlowdown);
+    if (soakMaximumWidgetGrowth >= 0)
+        m_soakRunner->setMaximumWidgetGrowth(soakMaximumWidgetGrowth);
+
+    // Style the synthetic window of the soak like the navigation widgets
+    m_themeMapping.addRule(StyleTargetCollector::NavigationTarget, "QMainWindow",
+                           ThemeMapping::ExactClass, QByteArray(),
+                           StyleSoakRunner::syntheticWindowName());
+}
 
-        QWidget *childWidget = qobject_cast<QWidget *>(childObject);
-        if (!childWidget)
+/*!
+ * \brief CreatorStyleEditPlugin::nameOutputPaneMainWidget
+ *        Give the main stacked widget of the OutputPaneManager a object name for better styling
+ *        through stylesheet.
+ *        This code assumes that the OutputPaneManager widget has only one direct child
+ *        QStackedWidget, which is the desired output widget. This can also be accomplished by a
+ *        patch of Qt Creator which sets the object name directly.
+ */
+void CreatorStyleEditPlugin::nameOutputPaneMainWidget(QWidget *outputPaneManagerWidget)
+{
+    foreach (QObject *childObject, outputPaneManagerWidget->children()) {
+        if (!childObject->isWidgetType())
             continue;
 
-        if (childWidget->inherits(className.toUtf8())) {
-            childWidget->setStyleSheet(stylesheet);
-        }
+        if (qstrcmp(childObject->metaObject()->className(), "QStackedWidget") == 0)
+            childObject->setObjectName(QStringLiteral("OutputPaneManagerMainWidget"));
+    }
+}
 
-        setStylesheetOnChildWidgetsWithClass(childWidget, stylesheet, className);
+/*!
+ * \brief CreatorStyleEditPlugin::setStylesheetOnWidget
+ *        Set the stylesheet on a widget, remember the original style of the widget and let the
+ *        paint budget monitor watch the widget. A widget the monitor degraded gets the degraded
+ *        stylesheet right away. The icons of the widget get the icon tint of the style.
+ */
+void CreatorStyleEditPlugin::setStylesheetOnWidget(QWidget *widget, const PreparedStyle &style)
+{
+    QString styleSheet = style.styleSheet();
+    if (m_applicationStyle) {
+        styleSheet = m_applicationStyle->paintBudgetMonitor()->watch(widget, style.styleSheet(),
+                                                                     style.degradedStyleSheet());
+        m_applicationStyle->addIconTintRoot(widget);
     }
+
+    m_styleBackup.setStyleSheet(widget, styleSheet);
 }
 
 QString CreatorStyleEditPlugin::customStyleSheetPathFromSettings() const
@@ -161,45 +258,6 @@ QString CreatorStyleEditPlugin::selectedStyleFromSettings() const
     return settings->value(settingsKey(selectedStyleSettingsKey)).toString();
 }
 
-QWidget *CreatorStyleEditPlugin::widgetForClass(const QString &className)
-{
-    foreach (QWidget *topLevelWidget, QApplication::topLevelWidgets()) {
-        QWidget *childWidgetWithClass = childWidgetForClass(topLevelWidget, className);
-        if (childWidgetWithClass != 0)
-            return childWidgetWithClass;
-    }
-
-    return 0;
-}
-
-/*!
- * \brief CreatorStyleEditPlugin::childWidgetForClass
- *        Get a pointer to a child widget that has a specific class name
- */
-QWidget *CreatorStyleEditPlugin::childWidgetForClass(QWidget *widget, const QString &className)
-{
-    QString widgetClassName(QString::fromUtf8(widget->metaObject()->className()));
-    if (widgetClassName.contains(className))
-        return widget;
-
-    foreach (QObject *childObject, widget->children()) {
-        if (!childObject->isWidgetType())
-            continue;
-
-        QWidget *childWidget = qobject_cast<QWidget *>(childObject);
-        if (!childWidget)
-            continue;
-
-        widgetClassName = QString::fromUtf8(childWidget->metaObject()->className());
-
-        if (QWidget *subChildWidget = childWidgetForClass(childWidget, className)) {
-            return subChildWidget;
-        }
-    }
-
-    return 0;
-}
-
 QString CreatorStyleEditPlugin::settingsKey(const QString &key) const
 {
     return QString(QStringLiteral("%1/%2"))
@@ -237,30 +295,110 @@ void CreatorStyleEditPlugin::writeStyleSheetToSettings()
                        m_styleEditor->selectedStyle());
 }
 
+/*!
+ * \brief CreatorStyleEditPlugin::applyStylesheet
+ *        Start preparing the selected stylesheet. It is committed to the widgets as soon as
+ *        it is ready.
+ */
 void CreatorStyleEditPlugin::applyStylesheet()
 {
-    QString styleSheetPath = m_styleEditor->styleSheetPath();
-    if (styleSheetPath.isEmpty())
+    m_stylePipeline->apply(m_styleEditor->styleSheetPath());
+}
+
+/*!
+ * \brief CreatorStyleEditPlugin::commitStylesheet
+ *        Set the prepared stylesheet on the widgets. This is the only part of applying a
+ *        style that runs on the GUI thread.
+ */
+void CreatorStyleEditPlugin::commitStylesheet(const PreparedStyle &style)
+{
+    m_committedStyle = style;
+
+    if (m_applicationStyle) {
+        m_applicationStyle->invalidateMetricsCache();
+        m_applicationStyle->setIconTint(style.iconTint());
+        m_applicationStyle->clearIconTintRoots();
+        if (style.isEmpty())
+            m_applicationStyle->clearThemeMapping();
+        else
+            m_applicationStyle->setThemeMapping(m_themeMapping);
+    }
+
+    if (style.isEmpty()) {
+        removeStylesheet();
         return;
+    }
 
-    QFile styleFile(styleSheetPath);
-    styleFile.open(QIODevice::ReadOnly);
-    QString styleContent(QString::fromUtf8(styleFile.readAll().data()));
-    styleFile.close();
+    StyleTargetCollector targetCollector(m_themeMapping);
+    targetCollector.collect();
 
-    Core::NavigationWidget::instance()->setStyleSheet(styleContent);
+    const QString coverageReport = targetCollector.coverageReport();
+    if (coverageReport != m_lastCoverageReport) {
+        qDebug() << "CreatorStyleEdit: styling" << qPrintable(coverageReport);
+        m_lastCoverageReport = coverageReport;
+    }
+
+    foreach (QWidget *navigationWidget,
+             targetCollector.targets(StyleTargetCollector::NavigationTarget)) {
+        setStylesheetOnWidget(navigationWidget, style);
+    }
 
     // QApplication::setPalette doesn't work for relyable for output widgets. So the
     // palette must be set explicit on the widget
-    QWidget *outputPaneManagerWidget = widgetForClass(QStringLiteral("Core::Internal::OutputPaneManager"));
-    if (outputPaneManagerWidget) {
-        outputPaneManagerWidget->setStyleSheet(styleContent);
+    foreach (QWidget *outputPaneManagerWidget,
+             targetCollector.targets(StyleTargetCollector::OutputPaneTarget)) {
+        nameOutputPaneMainWidget(outputPaneManagerWidget);
+        setStylesheetOnWidget(outputPaneManagerWidget, style);
     }
 
-    QWidget *debuggerMainWindow = widgetForClass(QStringLiteral("Debugger::DebuggerMainWindow"));
-    if (debuggerMainWindow) {
-        setStylesheetOnChildWidgetsWithClass(debuggerMainWindow, styleContent, QStringLiteral("QDockWidget"));
-    }
+    foreach (QWidget *dockWidget, targetCollector.targets(StyleTargetCollector::DebuggerDockTarget))
+        setStylesheetOnWidget(dockWidget, style);
+}
+
+/*!
+ * \brief CreatorStyleEditPlugin::removeStylesheet
+ *        Restore the original stylesheets and palettes of all styled widgets. Without a
+ *        stylesheet Qt drops the QStyleSheetStyle of the widgets together with its caches.
+ */
+void CreatorStyleEditPlugin::removeStylesheet()
+{
+    if (m_styleBackup.count() == 0)
+        return;
+
+    const qint64 memoryBefore = processResidentMemory();
+
+    if (m_applicationStyle)
+        m_applicationStyle->paintBudgetMonitor()->clear();
+
+    const int restoredCount = m_styleBackup.restore();
+
+    // The replaced stylesheet styles are deleted later, so measure once the event loop ran
+    QTimer::singleShot(0, this, [restoredCount, memoryBefore]() {
+        const qint64 memoryAfter = processResidentMemory();
+
+        qDebug() << "CreatorStyleEdit: removed stylesheet from" << restoredCount << "widgets,"
+                 << "resident memory" << memoryBefore / 1024 << "KiB ->" << memoryAfter / 1024 << "KiB";
+    });
+}
+
+/*!
+ * \brief CreatorStyleEditPlugin::themeTargetPolished
+ *        Style a target widget that was created after the stylesheet was committed, e.g. a
+ *        lazily created output pane or debugger dock
+ */
+void CreatorStyleEditPlugin::themeTargetPolished(QWidget *widget, int targetKind)
+{
+    if (m_committedStyle.isEmpty() || m_styleBackup.contains(widget))
+        return;
+
+    if (targetKind == StyleTargetCollector::OutputPaneTarget)
+        nameOutputPaneMainWidget(widget);
+    setStylesheetOnWidget(widget, m_committedStyle);
+
+    ++m_lateThemedWidgetCount;
+    qDebug() << "CreatorStyleEdit: styled" << widget->metaObject()->className()
+             << "after the stylesheet was applied," << m_lateThemedWidgetCount
+             << "late styled widgets";
 }
 
 void CreatorStyleEditPlugin::modeChanged(Core::IMode *mode)
@@ -270,5 +408,48 @@ void CreatorStyleEditPlugin::modeChanged(Core::IMode *mode)
     }
 }
 
+/*!
+ * \brief CreatorStyleEditPlugin::runDiagnostics
+ *        Run the benchmarks and the style soak test requested on the command line and
+ *        quit Qt Creator afterwards. The exit code is 1 if the soak test failed.
+ */
+void CreatorStyleEditPlugin::runDiagnostics()
+{
+    // Measure with the selected style committed
+    while (m_stylePipeline->isBusy())
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+
+    if (m_layoutBenchmarkIterations > 0) {
+        LayoutBenchmark layoutBenchmark(Core::ICore::mainWindow(), m_applicationStyle);
+        layoutBenchmark.setIterations(m_layoutBenchmarkIterations);
+        foreach (const QString &line, layoutBenchmark.run())
+            qDebug("%s", qPrintable(line));
+    }
+
+    if (m_iconTintBenchmarkIcons > 0) {
+        IconTintBenchmark iconTintBenchmark(m_applicationStyle);
+        iconTintBenchmark.setIconCount(m_iconTintBenchmarkIcons);
+        foreach (const QString &line, iconTintBenchmark.run())
+            qDebug("%s", qPrintable(line));
+    }
+
+    bool passed = true;
+    if (m_soakRunner) {
+        passed = m_soakRunner->run();
+
+        foreach (const QString &line, m_soakRunner->report()) {
+            if (passed)
+                qDebug("%s", qPrintable(line));
+            else
+                qWarning("%s", qPrintable(line));
+        }
+
+        if (!m_soakReportPath.isEmpty() && !m_soakRunner->writeReport(m_soakReportPath))
+            qWarning() << "Could not write style soak report to" << m_soakReportPath;
+    }
+
+    QCoreApplication::exit(passed ? 0 : 1);
+}
+
 Q_EXPORT_PLUGIN2(CreatorStyleEdit, CreatorStyleEditPlugin)
 
@@ -11,9 +11,13 @@
 
 #include <QPalette>
 #include "creatorstyleedit_global.h"
+#include "preparedstyle.h"
+#include "thememapping.h"
+#include "widgetstylebackup.h"
 #include <extensionsystem/iplugin.h>
 
 class QSettings;
+class ApplicationProxyStyle;
 
 namespace Core {
 class IMode;
@@ -23,6 +27,8 @@ namespace CreatorStyleEdit {
 namespace Internal {
 
 class StyleEditor;
+class StylePipeline;
+class StyleSoakRunner;
 
 class CreatorStyleEditPlugin : public ExtensionSystem::IPlugin
 {
@@ -43,18 +49,32 @@ private slots:
     void stylesheetChanged();
     void styleNameChanged(const QString &);
     void modeChanged(Core::IMode *mode);
+    void runDiagnostics();
+    void themeTargetPolished(QWidget *widget, int targetKind);
 
 private:
+    void parseArguments(const QStringList &arguments);
     QString customStyleSheetPathFromSettings() const;
     QString selectedStyleFromSettings() const;
-    QWidget *widgetForClass(const QString &className);
-    QWidget *childWidgetForClass(QWidget *widget, const QString &className);
     void writeStyleSheetToSettings();
     QString settingsKey(const QString &key) const;
-    void setStylesheetOnChildWidgetsWithClass(QWidget *widget, const QString &stylesheet,
-                                              const QString &className);
+    void nameOutputPaneMainWidget(QWidget *outputPaneManagerWidget);
+    void setStylesheetOnWidget(QWidget *widget, const PreparedStyle &style);
     void applyStylesheet();
+    void commitStylesheet(const PreparedStyle &style);
+    void removeStylesheet();
     StyleEditor *m_styleEditor;
+    ApplicationProxyStyle *m_applicationStyle;
+    StylePipeline *m_stylePipeline;
+    StyleSoakRunner *m_soakRunner;
+    QString m_soakReportPath;
+    int m_layoutBenchmarkIterations;
+    int m_iconTintBenchmarkIcons;
+    WidgetStyleBackup m_styleBackup;
+    QString m_lastCoverageReport;
+    ThemeMapping m_themeMapping;
+    PreparedStyle m_committedStyle;
+    int m_lateThemedWidgetCount;
 };
 
 } // namespace Internal
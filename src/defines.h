@@ -14,8 +14,11 @@
 namespace CreatorStyleEdit {
 namespace Internal {
 
+static const QString pluginNameSettingsKey(QStringLiteral("CreatorStyleEdit"));
 static const QString styleSheetPathSettingsKey(QStringLiteral("stylesheet path"));
 static const QString selectedStyleSettingsKey(QStringLiteral("selected style"));
+static const QString paintBudgetSettingsKey(QStringLiteral("paint budget"));
+static const QString metricsCacheSettingsKey(QStringLiteral("cache style metrics"));
 
 } // namespace Internal
 } // namespace CreatorStyleEdit
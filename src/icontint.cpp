@@ -0,0 +1,216 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QFile>
+#include <QImage>
+#include <QSettings>
+#include <QStringList>
+
+#include "icontint.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+static const QString iconsGroup(QStringLiteral("Icons"));
+static const QString tintKey(QStringLiteral("tint"));
+static const QString strengthKey(QStringLiteral("strength"));
+static const QString recolorKey(QStringLiteral("recolor"));
+
+/*!
+ * \brief multiplyAlpha
+ *        color * alpha / 255 without a division, exact for all 8 bit values
+ */
+static inline int multiplyAlpha(int color, int alpha)
+{
+    const int product = color * alpha + 128;
+    return (product + (product >> 8)) >> 8;
+}
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+using namespace CreatorStyleEdit::Internal;
+
+IconTint::IconTint() :
+    m_tint(0),
+    m_strength(0),
+    m_cacheKey(0)
+{
+}
+
+/*!
+ * \brief IconTint::IconTint
+ *        Blend all pixels towards the tint color. A strength of 1 replaces the color completely
+ *        and keeps only the alpha channel of the icon.
+ */
+IconTint::IconTint(const QColor &tint, qreal strength) :
+    m_tint(tint.rgb()),
+    m_strength(qBound(0, qRound(strength * 256), 256)),
+    m_cacheKey(0)
+{
+    updateCacheKey();
+}
+
+/*!
+ * \brief IconTint::fromFile
+ *        Read the icon rules of a style. A missing file results in a null tint.
+ */
+IconTint IconTint::fromFile(const QString &fileName)
+{
+    if (!QFile::exists(fileName))
+        return IconTint();
+
+    QSettings iconSettings(fileName, QSettings::IniFormat);
+    iconSettings.beginGroup(iconsGroup);
+
+    IconTint iconTint(QColor(iconSettings.value(tintKey).toString()),
+                      iconSettings.value(strengthKey, 0).toReal());
+
+    foreach (const QString &rule, iconSettings.value(recolorKey).toStringList()) {
+        const QStringList ruleParts = rule.split(QLatin1Char(' '), QString::SkipEmptyParts);
+        if (ruleParts.count() < 2)
+            continue;
+
+        const QColor from(ruleParts.at(0));
+        const QColor to(ruleParts.at(1));
+        if (!from.isValid() || !to.isValid())
+            continue;
+
+        iconTint.addRecolorRule(from, to, ruleParts.count() > 2 ? ruleParts.at(2).toInt() : 0);
+    }
+
+    return iconTint;
+}
+
+void IconTint::addRecolorRule(const QColor &from, const QColor &to, int tolerance)
+{
+    RecolorRule rule;
+    rule.from = from.rgb();
+    rule.to = to.rgb();
+    rule.tolerance = qBound(0, tolerance, 255);
+    m_recolorRules.append(rule);
+
+    updateCacheKey();
+}
+
+bool IconTint::isNull() const
+{
+    return m_strength == 0 && m_recolorRules.isEmpty();
+}
+
+/*!
+ * \brief IconTint::cacheKey
+ *        Key that is equal for tints with equal rules
+ */
+quint64 IconTint::cacheKey() const
+{
+    return m_cacheKey;
+}
+
+/*!
+ * \brief IconTint::apply
+ *        Recolor and tint the image in place. The image is converted to premultiplied ARGB32.
+ */
+void IconTint::apply(QImage *image) const
+{
+    if (isNull())
+        return;
+
+    if (image->format() != QImage::Format_ARGB32_Premultiplied) {
+        const qreal devicePixelRatio = image->devicePixelRatio();
+        *image = image->convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        image->setDevicePixelRatio(devicePixelRatio);
+    }
+
+    const int width = image->width();
+    for (int y = 0; y < image->height(); ++y) {
+        quint32 *pixels = reinterpret_cast<quint32 *>(image->scanLine(y));
+
+        foreach (const RecolorRule &rule, m_recolorRules)
+            recolorPixels(pixels, width, rule.from, rule.to, rule.tolerance);
+
+        if (m_strength > 0)
+            tintPixels(pixels, width, m_tint, m_strength);
+    }
+}
+
+/*!
+ * \brief IconTint::recolorPixels
+ *        Replace premultiplied pixels whose color channels all differ less than the tolerance
+ *        from the source color. The loop has no branches, so the compiler can vectorize it.
+ */
+void IconTint::recolorPixels(quint32 *pixels, int count, QRgb from, QRgb to, int tolerance)
+{
+    const int fromRed = qRed(from);
+    const int fromGreen = qGreen(from);
+    const int fromBlue = qBlue(from);
+    const int toRed = qRed(to);
+    const int toGreen = qGreen(to);
+    const int toBlue = qBlue(to);
+
+    for (int i = 0; i < count; ++i) {
+        const quint32 pixel = pixels[i];
+        const int alpha = int(pixel >> 24);
+        const int red = int((pixel >> 16) & 0xff);
+        const int green = int((pixel >> 8) & 0xff);
+        const int blue = int(pixel & 0xff);
+
+        // Compare in premultiplied space, so the rule colors and the tolerance get the alpha
+        // of the pixel
+        const int scaledTolerance = multiplyAlpha(tolerance, alpha);
+        const int redDistance = qAbs(red - multiplyAlpha(fromRed, alpha));
+        const int greenDistance = qAbs(green - multiplyAlpha(fromGreen, alpha));
+        const int blueDistance = qAbs(blue - multiplyAlpha(fromBlue, alpha));
+        const int matches = (redDistance <= scaledTolerance) & (greenDistance <= scaledTolerance)
+                & (blueDistance <= scaledTolerance) & (alpha != 0);
+        const quint32 mask = 0u - quint32(matches);
+
+        const quint32 recolored = (quint32(alpha) << 24)
+                | (quint32(multiplyAlpha(toRed, alpha)) << 16)
+                | (quint32(multiplyAlpha(toGreen, alpha)) << 8)
+                | quint32(multiplyAlpha(toBlue, alpha));
+
+        pixels[i] = (pixel & ~mask) | (recolored & mask);
+    }
+}
+
+/*!
+ * \brief IconTint::tintPixels
+ *        Blend premultiplied pixels towards the tint color, strength goes from 0 to 256.
+ *        The loop has no branches, so the compiler can vectorize it.
+ */
+void IconTint::tintPixels(quint32 *pixels, int count, QRgb tint, int strength)
+{
+    const int tintRed = qRed(tint);
+    const int tintGreen = qGreen(tint);
+    const int tintBlue = qBlue(tint);
+
+    for (int i = 0; i < count; ++i) {
+        const quint32 pixel = pixels[i];
+        const int alpha = int(pixel >> 24);
+        int red = int((pixel >> 16) & 0xff);
+        int green = int((pixel >> 8) & 0xff);
+        int blue = int(pixel & 0xff);
+
+        red += ((multiplyAlpha(tintRed, alpha) - red) * strength) / 256;
+        green += ((multiplyAlpha(tintGreen, alpha) - green) * strength) / 256;
+        blue += ((multiplyAlpha(tintBlue, alpha) - blue) * strength) / 256;
+
+        pixels[i] = (quint32(alpha) << 24) | (quint32(red) << 16) | (quint32(green) << 8)
+                | quint32(blue);
+    }
+}
+
+void IconTint::updateCacheKey()
+{
+    m_cacheKey = (quint64(m_tint) << 32) ^ quint64(m_strength);
+    foreach (const RecolorRule &rule, m_recolorRules) {
+        m_cacheKey = m_cacheKey * 1099511628211ULL
+                ^ ((quint64(rule.from) << 32) | rule.to) ^ quint64(rule.tolerance);
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef ICONTINT_H
+#define ICONTINT_H
+
+#include <QColor>
+#include <QMetaType>
+#include <QVector>
+
+class QImage;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The IconTint class
+ *        Icon recolor rules of a style. Pixels that are close to the source color of a recolor
+ *        rule get the target color, afterwards all pixels are blended towards the tint color.
+ *        The rules are read from an icons.ini file next to the stylesheet:
+ *
+ *        [Icons]
+ *        tint="#c8c8dc"
+ *        strength=0.5
+ *        recolor="#000000 #c8c8dc 96", "#303030 #c8c8dc 48"
+ */
+class IconTint
+{
+public:
+    IconTint();
+    IconTint(const QColor &tint, qreal strength);
+
+    static IconTint fromFile(const QString &fileName);
+
+    void addRecolorRule(const QColor &from, const QColor &to, int tolerance);
+
+    bool isNull() const;
+    quint64 cacheKey() const;
+    void apply(QImage *image) const;
+
+    static void recolorPixels(quint32 *pixels, int count, QRgb from, QRgb to, int tolerance);
+    static void tintPixels(quint32 *pixels, int count, QRgb tint, int strength);
+
+private:
+    struct RecolorRule {
+        QRgb from;
+        QRgb to;
+        int tolerance;
+    };
+
+    void updateCacheKey();
+
+    QVector<RecolorRule> m_recolorRules;
+    QRgb m_tint;
+    int m_strength;
+    quint64 m_cacheKey;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+Q_DECLARE_METATYPE(CreatorStyleEdit::Internal::IconTint)
+
+#endif // ICONTINT_H
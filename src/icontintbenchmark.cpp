@@ -0,0 +1,121 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+
+#include "applicationproxystyle.h"
+#include "icontint.h"
+#include "icontintbenchmark.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+static const int benchmarkIconSizes[] = { 16, 24, 32, 48, 64, 128 };
+static const int benchmarkIconSizeCount = sizeof(benchmarkIconSizes) / sizeof(benchmarkIconSizes[0]);
+
+/*!
+ * \brief benchmarkIcon
+ *        Dark icon with an antialiased looking alpha ramp, similar to the monochrome icons of
+ *        Qt Creator
+ */
+static QImage benchmarkIcon(int size, int seed)
+{
+    QImage icon(size, size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < size; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(icon.scanLine(y));
+        for (int x = 0; x < size; ++x) {
+            const int alpha = ((x + y + seed) * 255 / (2 * size)) & 0xff;
+            line[x] = qPremultiply(qRgba(0x30, 0x30, 0x38 + seed % 16, alpha));
+        }
+    }
+
+    return icon;
+}
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+using namespace CreatorStyleEdit::Internal;
+
+IconTintBenchmark::IconTintBenchmark(ApplicationProxyStyle *style) :
+    m_style(style),
+    m_iconCount(1000)
+{
+}
+
+void IconTintBenchmark::setIconCount(int iconCount)
+{
+    m_iconCount = iconCount;
+}
+
+/*!
+ * \brief IconTintBenchmark::run
+ *        Uses the icon tint of the current style, or a sample tint if the style has none
+ */
+QStringList IconTintBenchmark::run()
+{
+    QStringList report;
+
+    IconTint iconTint = m_style->iconTint();
+    const bool styleHasTint = !iconTint.isNull();
+    if (!styleHasTint) {
+        iconTint = IconTint(QColor(0xc8, 0xc8, 0xdc), 0.5);
+        iconTint.addRecolorRule(QColor(0x30, 0x30, 0x30), QColor(0xc8, 0xc8, 0xdc), 48);
+    }
+
+    QList<QImage> icons;
+    qint64 pixelCount = 0;
+    for (int i = 0; i < m_iconCount; ++i) {
+        const int size = benchmarkIconSizes[i % benchmarkIconSizeCount];
+        icons.append(benchmarkIcon(size, i));
+        pixelCount += size * size;
+    }
+
+    QElapsedTimer benchmarkTimer;
+    benchmarkTimer.start();
+    for (int i = 0; i < icons.count(); ++i)
+        iconTint.apply(&icons[i]);
+    const qint64 kernelTime = qMax(Q_INT64_C(1), benchmarkTimer.nsecsElapsed());
+
+    report.append(QString(QStringLiteral("Icon tint benchmark: %1 icons, %2 pixels, kernel %3 us, "
+                                         "%4 megapixels per second"))
+                  .arg(m_iconCount)
+                  .arg(pixelCount)
+                  .arg(kernelTime / 1000)
+                  .arg(double(pixelCount) * 1000.0 / double(kernelTime), 0, 'f', 1));
+
+    if (!styleHasTint) {
+        report.append(QStringLiteral("Icon tint benchmark: the current style has no icon tint, "
+                                     "skipping the pixmap cache"));
+        return report;
+    }
+
+    QList<QPixmap> pixmaps;
+    foreach (const QImage &icon, icons)
+        pixmaps.append(QPixmap::fromImage(icon));
+
+    benchmarkTimer.start();
+    foreach (const QPixmap &pixmap, pixmaps)
+        m_style->tintedPixmap(pixmap, QIcon::Normal);
+    const qint64 firstDrawTime = benchmarkTimer.nsecsElapsed();
+
+    benchmarkTimer.start();
+    foreach (const QPixmap &pixmap, pixmaps)
+        m_style->tintedPixmap(pixmap, QIcon::Normal);
+    const qint64 cachedDrawTime = benchmarkTimer.nsecsElapsed();
+
+    report.append(QString(QStringLiteral("Icon tint benchmark: first request %1 us, "
+                                         "cached request %2 us for all icons"))
+                  .arg(firstDrawTime / 1000)
+                  .arg(cachedDrawTime / 1000));
+
+    return report;
+}
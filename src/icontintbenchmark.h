@@ -0,0 +1,40 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef ICONTINTBENCHMARK_H
+#define ICONTINTBENCHMARK_H
+
+#include <QStringList>
+
+class ApplicationProxyStyle;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The IconTintBenchmark class
+ *        Measures the icon recolor kernel on a large set of generated icons and the first and
+ *        repeated tinted pixmap requests of the application style
+ */
+class IconTintBenchmark
+{
+public:
+    explicit IconTintBenchmark(ApplicationProxyStyle *style);
+
+    void setIconCount(int iconCount);
+    QStringList run();
+
+private:
+    ApplicationProxyStyle *m_style;
+    int m_iconCount;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // ICONTINTBENCHMARK_H
@@ -0,0 +1,84 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QWidget>
+
+#include "applicationproxystyle.h"
+#include "layoutbenchmark.h"
+
+using namespace CreatorStyleEdit::Internal;
+
+LayoutBenchmark::LayoutBenchmark(QWidget *window, ApplicationProxyStyle *style) :
+    m_window(window),
+    m_style(style),
+    m_iterations(100)
+{
+}
+
+void LayoutBenchmark::setIterations(int iterations)
+{
+    m_iterations = iterations;
+}
+
+/*!
+ * \brief LayoutBenchmark::run
+ *        Run the benchmark once without measuring to fill the stylesheet caches, then without and
+ *        with the metrics cache. The window gets its original size and the metrics cache its
+ *        original state afterwards.
+ */
+QStringList LayoutBenchmark::run()
+{
+    QStringList report;
+
+    const bool metricsCacheWasEnabled = m_style->isMetricsCacheEnabled();
+    const QSize originalSize = m_window->size();
+
+    m_style->setMetricsCacheEnabled(false);
+    resizeWindow(originalSize);
+    const qint64 uncachedTime = resizeWindow(originalSize);
+
+    m_style->setMetricsCacheEnabled(true);
+    const quint64 hitsBefore = m_style->metricsCacheHits();
+    const quint64 missesBefore = m_style->metricsCacheMisses();
+    const qint64 cachedTime = resizeWindow(originalSize);
+    const quint64 hits = m_style->metricsCacheHits() - hitsBefore;
+    const quint64 misses = m_style->metricsCacheMisses() - missesBefore;
+
+    m_style->setMetricsCacheEnabled(metricsCacheWasEnabled);
+    m_window->resize(originalSize);
+
+    report.append(QString(QStringLiteral("Layout benchmark: %1 resizes of %2"))
+                  .arg(m_iterations)
+                  .arg(QString::fromUtf8(m_window->metaObject()->className())));
+    report.append(QString(QStringLiteral("Layout benchmark: without metrics cache %1 us per resize"))
+                  .arg(uncachedTime / qMax(1, m_iterations) / 1000));
+    report.append(QString(QStringLiteral("Layout benchmark: with metrics cache %1 us per resize, "
+                                         "%2 hits, %3 misses"))
+                  .arg(cachedTime / qMax(1, m_iterations) / 1000)
+                  .arg(hits)
+                  .arg(misses));
+
+    return report;
+}
+
+qint64 LayoutBenchmark::resizeWindow(const QSize &baseSize) const
+{
+    QElapsedTimer layoutTimer;
+    layoutTimer.start();
+
+    for (int i = 0; i < m_iterations; ++i) {
+        const int shrink = (i % 10) * 40;
+        m_window->resize(baseSize.width() - shrink, baseSize.height() - shrink / 2);
+        QCoreApplication::sendPostedEvents(0, QEvent::LayoutRequest);
+    }
+
+    return layoutTimer.nsecsElapsed();
+}
@@ -0,0 +1,45 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef LAYOUTBENCHMARK_H
+#define LAYOUTBENCHMARK_H
+
+#include <QSize>
+#include <QStringList>
+
+class QWidget;
+class ApplicationProxyStyle;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The LayoutBenchmark class
+ *        Resizes a window repeatedly with and without the metrics cache of the application
+ *        style and reports the layout time of both runs
+ */
+class LayoutBenchmark
+{
+public:
+    LayoutBenchmark(QWidget *window, ApplicationProxyStyle *style);
+
+    void setIterations(int iterations);
+    QStringList run();
+
+private:
+    qint64 resizeWindow(const QSize &baseSize) const;
+
+    QWidget *m_window;
+    ApplicationProxyStyle *m_style;
+    int m_iterations;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // LAYOUTBENCHMARK_H
@@ -0,0 +1,242 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QWidget>
+
+#include "paintbudgetmonitor.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+// Number of recent frames a decision is based on
+static const int paintWindowSize = 20;
+// Minimum time in milliseconds a subtree stays degraded, doubled if the full style is too slow again
+static const qint64 initialHoldTime = 5000;
+static const qint64 maximumHoldTime = 5 * 60 * 1000;
+// A full style that is too slow again within this time in milliseconds extends the hold time
+static const qint64 relapseTime = 30000;
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+using namespace CreatorStyleEdit::Internal;
+
+PaintBudgetMonitor::PaintBudgetMonitor(QObject *parent) :
+    QObject(parent),
+    m_budget(0),
+    m_measuringPaint(false),
+    m_framePending(false)
+{
+}
+
+PaintBudgetMonitor::~PaintBudgetMonitor()
+{
+    qDeleteAll(m_subtrees);
+}
+
+/*!
+ * \brief PaintBudgetMonitor::setBudget
+ *        Set the paint budget in milliseconds. A budget of 0 disables the monitor.
+ */
+void PaintBudgetMonitor::setBudget(int milliseconds)
+{
+    m_budget = qint64(milliseconds) * 1000000;
+    if (m_budget == 0)
+        clear();
+}
+
+int PaintBudgetMonitor::budget() const
+{
+    return int(m_budget / 1000000);
+}
+
+/*!
+ * \brief PaintBudgetMonitor::watch
+ *        Measure the paint time of the root widget and its children. Returns the stylesheet the
+ *        caller has to set on the root: the degraded stylesheet for a root that is degraded
+ *        already, the full stylesheet otherwise.
+ */
+QString PaintBudgetMonitor::watch(QWidget *root, const QString &styleSheet,
+                                  const QString &degradedStyleSheet)
+{
+    if (m_budget == 0)
+        return styleSheet;
+
+    foreach (Subtree *subtree, m_subtrees) {
+        if (subtree->root != root)
+            continue;
+
+        subtree->styleSheet = styleSheet;
+        subtree->degradedStyleSheet = degradedStyleSheet;
+        return subtree->degraded ? degradedStyleSheet : styleSheet;
+    }
+
+    Subtree *subtree = new Subtree;
+    subtree->root = root;
+    subtree->styleSheet = styleSheet;
+    subtree->degradedStyleSheet = degradedStyleSheet;
+    subtree->framePaintTime = 0;
+    subtree->paintTimes.fill(0, paintWindowSize);
+    subtree->nextPaintTime = 0;
+    subtree->degraded = false;
+    subtree->transitionTimer.start();
+    subtree->restoreTimer.invalidate();
+    subtree->holdTime = initialHoldTime;
+    m_subtrees.append(subtree);
+
+    root->installEventFilter(this);
+    foreach (QWidget *childWidget, root->findChildren<QWidget *>())
+        childWidget->installEventFilter(this);
+
+    return styleSheet;
+}
+
+/*!
+ * \brief PaintBudgetMonitor::clear
+ *        Stop measuring all subtrees. The stylesheets of the subtrees are left as they are.
+ */
+void PaintBudgetMonitor::clear()
+{
+    foreach (Subtree *subtree, m_subtrees) {
+        if (QWidget *root = subtree->root.data()) {
+            root->removeEventFilter(this);
+            foreach (QWidget *childWidget, root->findChildren<QWidget *>())
+                childWidget->removeEventFilter(this);
+        }
+        delete subtree;
+    }
+
+    m_subtrees.clear();
+}
+
+/*!
+ * \brief PaintBudgetMonitor::widgetPolished
+ *        Measure widgets that are created inside of a watched subtree as well
+ */
+void PaintBudgetMonitor::widgetPolished(QWidget *widget)
+{
+    if (m_subtrees.isEmpty())
+        return;
+
+    if (subtreeForWidget(widget))
+        widget->installEventFilter(this);
+}
+
+bool PaintBudgetMonitor::eventFilter(QObject *watched, QEvent *event)
+{
+    // The paint event is delivered again from here to measure how long the widget takes.
+    // The nested delivery passes this filter untouched, but other filters see it again.
+    if (event->type() != QEvent::Paint || m_measuringPaint || !watched->isWidgetType())
+        return false;
+
+    Subtree *subtree = subtreeForWidget(static_cast<QWidget *>(watched));
+    if (!subtree)
+        return false;
+
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+    m_measuringPaint = true;
+    QCoreApplication::sendEvent(watched, event);
+    m_measuringPaint = false;
+
+    // All widgets that need a repaint are painted in one pass, so the frame is finished as
+    // soon as the event loop continues
+    subtree->framePaintTime += paintTimer.nsecsElapsed();
+    if (!m_framePending) {
+        m_framePending = true;
+        QMetaObject::invokeMethod(this, "finishFrame", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+/*!
+ * \brief PaintBudgetMonitor::finishFrame
+ *        Account the summed paint time of the last repaint pass to every subtree. Switching
+ *        the stylesheet polishes the whole subtree again, so it must not happen while painting.
+ */
+void PaintBudgetMonitor::finishFrame()
+{
+    m_framePending = false;
+
+    foreach (Subtree *subtree, m_subtrees) {
+        if (subtree->framePaintTime == 0 || !subtree->root)
+            continue;
+
+        const qint64 framePaintTime = subtree->framePaintTime;
+        subtree->framePaintTime = 0;
+        addPaintTime(subtree, framePaintTime);
+    }
+}
+
+PaintBudgetMonitor::Subtree *PaintBudgetMonitor::subtreeForWidget(QWidget *widget)
+{
+    for (QWidget *ancestor = widget; ancestor; ancestor = ancestor->parentWidget()) {
+        foreach (Subtree *subtree, m_subtrees) {
+            if (subtree->root == ancestor)
+                return subtree;
+        }
+    }
+
+    return 0;
+}
+
+void PaintBudgetMonitor::addPaintTime(Subtree *subtree, qint64 paintTime)
+{
+    subtree->paintTimes[subtree->nextPaintTime] = paintTime;
+    subtree->nextPaintTime = (subtree->nextPaintTime + 1) % paintWindowSize;
+
+    int overBudgetCount = 0;
+    qint64 maximumPaintTime = 0;
+    foreach (qint64 recentPaintTime, subtree->paintTimes) {
+        if (recentPaintTime > m_budget)
+            ++overBudgetCount;
+        maximumPaintTime = qMax(maximumPaintTime, recentPaintTime);
+    }
+
+    if (!subtree->degraded) {
+        if (overBudgetCount > paintWindowSize / 2)
+            degrade(subtree);
+    } else if (subtree->transitionTimer.elapsed() > subtree->holdTime
+               && maximumPaintTime < m_budget / 4) {
+        restore(subtree);
+    }
+}
+
+void PaintBudgetMonitor::degrade(Subtree *subtree)
+{
+    // The full style was too slow right after it was restored, so wait longer next time
+    if (subtree->restoreTimer.isValid() && subtree->restoreTimer.elapsed() < relapseTime)
+        subtree->holdTime = qMin(subtree->holdTime * 2, maximumHoldTime);
+    else
+        subtree->holdTime = initialHoldTime;
+
+    qDebug() << "CreatorStyleEdit: paints of" << subtree->root->metaObject()->className()
+             << "exceed the budget of" << budget() << "ms, switching to the degraded style for at least"
+             << subtree->holdTime / 1000 << "s";
+
+    subtree->degraded = true;
+    subtree->transitionTimer.start();
+    subtree->paintTimes.fill(0);
+    subtree->root->setStyleSheet(subtree->degradedStyleSheet);
+}
+
+void PaintBudgetMonitor::restore(Subtree *subtree)
+{
+    qDebug() << "CreatorStyleEdit: paints of" << subtree->root->metaObject()->className()
+             << "are well within the budget of" << budget() << "ms, switching back to the full style";
+
+    subtree->degraded = false;
+    subtree->transitionTimer.start();
+    subtree->restoreTimer.start();
+    subtree->paintTimes.fill(0);
+    subtree->root->setStyleSheet(subtree->styleSheet);
+}
+
@@ -0,0 +1,81 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef PAINTBUDGETMONITOR_H
+#define PAINTBUDGETMONITOR_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class QWidget;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The PaintBudgetMonitor class
+ *        Measures how long the widgets of styled subtrees take to paint per repaint pass. If most
+ *        of the recent frames of a subtree exceed the budget, the subtree gets the cheaper
+ *        degraded stylesheet. After a hold time the full stylesheet is tried again, if the
+ *        degraded one paints well within the budget.
+ *        Paint events of watched widgets are sent a second time to measure them, so application
+ *        wide event filters and event filters installed after the monitor see them twice.
+ */
+class PaintBudgetMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PaintBudgetMonitor(QObject *parent = 0);
+    ~PaintBudgetMonitor();
+
+    void setBudget(int milliseconds);
+    int budget() const;
+
+    QString watch(QWidget *root, const QString &styleSheet, const QString &degradedStyleSheet);
+    void clear();
+    void widgetPolished(QWidget *widget);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
+private slots:
+    void finishFrame();
+
+private:
+    struct Subtree {
+        QPointer<QWidget> root;
+        QString styleSheet;
+        QString degradedStyleSheet;
+        qint64 framePaintTime;
+        QVector<qint64> paintTimes;
+        int nextPaintTime;
+        bool degraded;
+        QElapsedTimer transitionTimer;
+        QElapsedTimer restoreTimer;
+        qint64 holdTime;
+    };
+
+    Subtree *subtreeForWidget(QWidget *widget);
+    void addPaintTime(Subtree *subtree, qint64 paintTime);
+    void degrade(Subtree *subtree);
+    void restore(Subtree *subtree);
+
+    QList<Subtree *> m_subtrees;
+    qint64 m_budget;
+    bool m_measuringPaint;
+    bool m_framePending;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // PAINTBUDGETMONITOR_H
@@ -0,0 +1,274 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include "preparedstyle.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+// Characters around which whitespace has no meaning inside and outside of a rule block
+static const QString declarationSeparators(QStringLiteral("{};,:"));
+static const QString selectorSeparators(QStringLiteral("{};,>"));
+
+static const QString iconTintFileName(QStringLiteral("icons.ini"));
+
+static const QString hoverPseudoState(QStringLiteral(":hover"));
+static const QRegularExpression gradientExpression(QStringLiteral("q(linear|radial|conical)gradient\\("));
+static const QRegularExpression firstStopExpression(QStringLiteral("stop:[0-9.]+ *"));
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+using namespace CreatorStyleEdit::Internal;
+
+PreparedStyle::PreparedStyle()
+{
+}
+
+/*!
+ * \brief PreparedStyle::fromFile
+ *        Read and prepare the stylesheet. This doesn't touch any widget, so it can be
+ *        called from a worker thread.
+ */
+PreparedStyle PreparedStyle::fromFile(const QString &styleSheetPath)
+{
+    PreparedStyle style;
+    style.m_path = styleSheetPath;
+    if (styleSheetPath.isEmpty())
+        return style;
+
+    QFile styleFile(styleSheetPath);
+    if (!styleFile.open(QIODevice::ReadOnly)) {
+        style.m_errorString = styleFile.errorString();
+        return style;
+    }
+
+    QString styleContent(QString::fromUtf8(styleFile.readAll()));
+    styleFile.close();
+
+    style.m_styleSheet = compactStyleSheet(styleContent, &style.m_errorString);
+    style.m_degradedStyleSheet = degradeStyleSheet(style.m_styleSheet);
+    style.m_iconTint = IconTint::fromFile(QFileInfo(styleSheetPath).absolutePath()
+                                          + QLatin1Char('/') + iconTintFileName);
+    return style;
+}
+
+QString PreparedStyle::path() const
+{
+    return m_path;
+}
+
+QString PreparedStyle::styleSheet() const
+{
+    return m_styleSheet;
+}
+
+/*!
+ * \brief PreparedStyle::degradedStyleSheet
+ *        Cheaper variant of the stylesheet without hover rules and with flat colors instead
+ *        of gradients. Used for widgets that take too long to paint.
+ */
+QString PreparedStyle::degradedStyleSheet() const
+{
+    return m_degradedStyleSheet;
+}
+
+/*!
+ * \brief PreparedStyle::iconTint
+ *        Icon recolor rules from the icons.ini file next to the stylesheet
+ */
+IconTint PreparedStyle::iconTint() const
+{
+    return m_iconTint;
+}
+
+bool PreparedStyle::isEmpty() const
+{
+    return m_path.isEmpty();
+}
+
+bool PreparedStyle::isValid() const
+{
+    return m_errorString.isEmpty();
+}
+
+QString PreparedStyle::errorString() const
+{
+    return m_errorString;
+}
+
+/*!
+ * \brief PreparedStyle::compactStyleSheet
+ *        Remove comments and whitespace that doesn't change the meaning of the stylesheet,
+ *        so the stylesheet parser on the GUI thread has less to do. Unbalanced braces,
+ *        comments and strings are reported as error.
+ */
+QString PreparedStyle::compactStyleSheet(const QString &styleSheet, QString *errorString)
+{
+    QString compacted;
+    compacted.reserve(styleSheet.size());
+
+    const int length = styleSheet.size();
+    int braceDepth = 0;
+    bool pendingSpace = false;
+    QChar quote;
+
+    for (int i = 0; i < length; ++i) {
+        const QChar c = styleSheet.at(i);
+
+        if (!quote.isNull()) {
+            compacted.append(c);
+            if (c == QLatin1Char('\\') && i + 1 < length)
+                compacted.append(styleSheet.at(++i));
+            else if (c == quote)
+                quote = QChar();
+            continue;
+        }
+
+        if (c == QLatin1Char('/') && i + 1 < length && styleSheet.at(i + 1) == QLatin1Char('*')) {
+            const int commentEnd = styleSheet.indexOf(QStringLiteral("*/"), i + 2);
+            if (commentEnd < 0) {
+                *errorString = QStringLiteral("Unterminated comment");
+                return QString();
+            }
+            i = commentEnd + 1;
+            pendingSpace = true;
+            continue;
+        }
+
+        if (c.isSpace()) {
+            pendingSpace = true;
+            continue;
+        }
+
+        if (pendingSpace && !compacted.isEmpty()) {
+            // Whitespace is only needed between selectors and between values
+            const QString &separators = braceDepth > 0 ? declarationSeparators
+                                                       : selectorSeparators;
+            if (!separators.contains(compacted.at(compacted.size() - 1)) && !separators.contains(c))
+                compacted.append(QLatin1Char(' '));
+        }
+        pendingSpace = false;
+
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            quote = c;
+        } else if (c == QLatin1Char('{')) {
+            ++braceDepth;
+        } else if (c == QLatin1Char('}')) {
+            if (--braceDepth < 0) {
+                *errorString = QStringLiteral("Unexpected '}'");
+                return QString();
+            }
+        }
+
+        compacted.append(c);
+    }
+
+    if (!quote.isNull()) {
+        *errorString = QStringLiteral("Unterminated string");
+        return QString();
+    }
+    if (braceDepth != 0) {
+        *errorString = QStringLiteral("Missing '}'");
+        return QString();
+    }
+
+    return compacted;
+}
+
+/*!
+ * \brief PreparedStyle::degradeStyleSheet
+ *        Drop all selectors with a hover state and flatten all gradients of a compacted
+ *        stylesheet
+ */
+QString PreparedStyle::degradeStyleSheet(const QString &styleSheet)
+{
+    QString degraded;
+    degraded.reserve(styleSheet.size());
+
+    int ruleStart = 0;
+    while (ruleStart < styleSheet.size()) {
+        const int blockStart = styleSheet.indexOf(QLatin1Char('{'), ruleStart);
+        const int blockEnd = styleSheet.indexOf(QLatin1Char('}'), blockStart);
+        if (blockStart < 0 || blockEnd < 0)
+            break;
+
+        QStringList selectors;
+        foreach (const QString &selector,
+                 styleSheet.mid(ruleStart, blockStart - ruleStart).split(QLatin1Char(','))) {
+            if (!selector.contains(hoverPseudoState))
+                selectors.append(selector);
+        }
+
+        if (!selectors.isEmpty()) {
+            degraded.append(selectors.join(QLatin1Char(',')));
+            degraded.append(QLatin1Char('{'));
+            degraded.append(flattenGradients(styleSheet.mid(blockStart + 1, blockEnd - blockStart - 1)));
+            degraded.append(QLatin1Char('}'));
+        }
+
+        ruleStart = blockEnd + 1;
+    }
+
+    return degraded;
+}
+
+/*!
+ * \brief PreparedStyle::flattenGradients
+ *        Replace every gradient by the color of its first stop
+ */
+QString PreparedStyle::flattenGradients(const QString &declarations)
+{
+    QString flattened = declarations;
+
+    QRegularExpressionMatch gradientMatch = gradientExpression.match(flattened);
+    while (gradientMatch.hasMatch()) {
+        // Find the closing parenthesis of the gradient, colors can contain parentheses as well
+        int depth = 1;
+        int gradientEnd = gradientMatch.capturedEnd();
+        while (gradientEnd < flattened.size() && depth > 0) {
+            if (flattened.at(gradientEnd) == QLatin1Char('('))
+                ++depth;
+            else if (flattened.at(gradientEnd) == QLatin1Char(')'))
+                --depth;
+            ++gradientEnd;
+        }
+
+        const QString gradient = flattened.mid(gradientMatch.capturedStart(),
+                                               gradientEnd - gradientMatch.capturedStart());
+        QRegularExpressionMatch stopMatch = firstStopExpression.match(gradient);
+        if (depth != 0 || !stopMatch.hasMatch())
+            break;
+
+        // The color ends at the next comma or at the end of the gradient, outside of parentheses
+        int colorEnd = stopMatch.capturedEnd();
+        int colorDepth = 0;
+        while (colorEnd < gradient.size() - 1) {
+            const QChar c = gradient.at(colorEnd);
+            if (c == QLatin1Char('('))
+                ++colorDepth;
+            else if (c == QLatin1Char(')'))
+                --colorDepth;
+            else if (c == QLatin1Char(',') && colorDepth == 0)
+                break;
+            ++colorEnd;
+        }
+
+        const QString color = gradient.mid(stopMatch.capturedEnd(), colorEnd - stopMatch.capturedEnd());
+        flattened.replace(gradientMatch.capturedStart(), gradient.size(), color);
+
+        gradientMatch = gradientExpression.match(flattened, gradientMatch.capturedStart() + color.size());
+    }
+
+    return flattened;
+}
@@ -0,0 +1,58 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef PREPAREDSTYLE_H
+#define PREPAREDSTYLE_H
+
+#include <QMetaType>
+#include <QString>
+
+#include "icontint.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The PreparedStyle class
+ *        Read, decoded and validated stylesheet that is ready to be set on widgets.
+ *        A prepared style is immutable and can be created on any thread. A prepared style
+ *        without a path means that no style should be set at all.
+ */
+class PreparedStyle
+{
+public:
+    PreparedStyle();
+
+    static PreparedStyle fromFile(const QString &styleSheetPath);
+
+    QString path() const;
+    QString styleSheet() const;
+    QString degradedStyleSheet() const;
+    IconTint iconTint() const;
+    bool isEmpty() const;
+    bool isValid() const;
+    QString errorString() const;
+
+private:
+    static QString compactStyleSheet(const QString &styleSheet, QString *errorString);
+    static QString degradeStyleSheet(const QString &styleSheet);
+    static QString flattenGradients(const QString &declarations);
+
+    QString m_path;
+    QString m_styleSheet;
+    QString m_degradedStyleSheet;
+    IconTint m_iconTint;
+    QString m_errorString;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+Q_DECLARE_METATYPE(CreatorStyleEdit::Internal::PreparedStyle)
+
+#endif // PREPAREDSTYLE_H
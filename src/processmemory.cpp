@@ -0,0 +1,66 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include "processmemory.h"
+
+#if defined(Q_OS_WIN)
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(Q_OS_MAC)
+#  include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#  include <QFile>
+#  include <QList>
+#  include <QByteArray>
+#  include <unistd.h>
+#endif
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+qint64 processResidentMemory()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+
+    return qint64(counters.WorkingSetSize);
+#elif defined(Q_OS_MAC)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return -1;
+    }
+
+    return qint64(info.resident_size);
+#elif defined(Q_OS_LINUX)
+    // The second field of statm is the resident set size in pages
+    QFile statmFile(QStringLiteral("/proc/self/statm"));
+    if (!statmFile.open(QIODevice::ReadOnly))
+        return -1;
+
+    QList<QByteArray> fields = statmFile.readAll().split(' ');
+    statmFile.close();
+    if (fields.count() < 2)
+        return -1;
+
+    bool ok = false;
+    qint64 residentPages = fields.at(1).toLongLong(&ok);
+    if (!ok)
+        return -1;
+
+    return residentPages * qint64(sysconf(_SC_PAGESIZE));
+#else
+    return -1;
+#endif
+}
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
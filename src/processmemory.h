@@ -0,0 +1,27 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+#include <QtGlobal>
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief processResidentMemory
+ *        Resident memory of the running process in bytes, or -1 if the platform
+ *        doesn't provide it.
+ */
+qint64 processResidentMemory();
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // PROCESSMEMORY_H
@@ -0,0 +1,343 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QSettings>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include "defines.h"
+#include "preparedstyle.h"
+#include "stylecatalog.h"
+
+using namespace CreatorStyleEdit::Internal;
+
+namespace {
+
+// Untranslated names of the style list entries of the style editor
+const QString noStyleName(QStringLiteral("No Style"));
+const QString customStyleName(QStringLiteral("Custom Style"));
+
+struct Installation {
+    QString creatorPath;
+    QString settingsPath;
+    // Directories the jobs of the installation write
+    QString uniqueResourcePath;
+    QString uniqueSettingsPath;
+};
+
+struct ProvisionResult {
+    ProvisionResult() : success(false), elapsedTime(0) {}
+
+    QString path;
+    bool success;
+    QStringList messages;
+    qint64 elapsedTime;
+};
+
+/*!
+ * \brief The ColorSchemeInstaller struct
+ *        Installs the color schemes of all bundled styles into one Qt Creator resource
+ *        directory, is called from the thread pool
+ */
+struct ColorSchemeInstaller
+{
+    typedef ProvisionResult result_type;
+
+    ProvisionResult operator()(const QString &resourcePath) const;
+};
+
+/*!
+ * \brief The SettingsWriter struct
+ *        Selects the style in one settings directory, is called from the thread pool
+ */
+struct SettingsWriter
+{
+    typedef ProvisionResult result_type;
+
+    QString selectedStyle;
+    QString styleSheetPath;
+
+    ProvisionResult operator()(const QString &settingsPath) const;
+};
+
+/*!
+ * \brief creatorResourcePath
+ *        The directory Core::ICore::resourcePath() points to for the Qt Creator installation
+ */
+QString creatorResourcePath(const QString &creatorPath)
+{
+    QDir creatorDir(creatorPath);
+    if (creatorDir.exists(QStringLiteral("share/qtcreator")))
+        return creatorDir.absoluteFilePath(QStringLiteral("share/qtcreator"));
+    if (creatorDir.exists(QStringLiteral("Contents/Resources")))
+        return creatorDir.absoluteFilePath(QStringLiteral("Contents/Resources"));
+
+    return creatorDir.absolutePath();
+}
+
+/*!
+ * \brief uniquePath
+ *        Path that is the same for every spelling of a directory, so a directory is only
+ *        written by one job
+ */
+QString uniquePath(const QString &path)
+{
+    const QFileInfo pathInfo(path);
+    const QString canonicalPath = pathInfo.canonicalFilePath();
+    return canonicalPath.isEmpty() ? QDir::cleanPath(pathInfo.absoluteFilePath()) : canonicalPath;
+}
+
+QString settingsKey(const QString &key)
+{
+    return QString(QStringLiteral("%1/%2"))
+            .arg(pluginNameSettingsKey)
+            .arg(key);
+}
+
+ProvisionResult ColorSchemeInstaller::operator()(const QString &resourcePath) const
+{
+    QElapsedTimer provisionTimer;
+    provisionTimer.start();
+
+    ProvisionResult result;
+    result.path = resourcePath;
+    result.success = true;
+
+    foreach (const StyleInfo &style, StyleCatalog::bundledStyles()) {
+        QString errorString;
+        if (!StyleCatalog::installColorScheme(style, resourcePath, &errorString)) {
+            result.success = false;
+            result.messages.append(QString(QStringLiteral("color scheme of %1: %2"))
+                                   .arg(style.name)
+                                   .arg(errorString));
+        }
+    }
+
+    result.elapsedTime = provisionTimer.nsecsElapsed();
+    return result;
+}
+
+ProvisionResult SettingsWriter::operator()(const QString &settingsPath) const
+{
+    QElapsedTimer provisionTimer;
+    provisionTimer.start();
+
+    ProvisionResult result;
+    result.path = settingsPath;
+    result.success = true;
+
+    // The same file Qt Creator uses when started with -settingspath
+    QSettings settings(settingsPath + QStringLiteral("/QtProject/QtCreator.ini"),
+                       QSettings::IniFormat);
+    settings.setValue(settingsKey(selectedStyleSettingsKey), selectedStyle);
+    if (!styleSheetPath.isEmpty())
+        settings.setValue(settingsKey(styleSheetPathSettingsKey), styleSheetPath);
+    settings.sync();
+
+    if (settings.status() != QSettings::NoError) {
+        result.success = false;
+        result.messages.append(QStringLiteral("can't write settings"));
+    }
+
+    result.elapsedTime = provisionTimer.nsecsElapsed();
+    return result;
+}
+
+/*!
+ * \brief reportInstallations
+ *        Print the result of every installation: the time of the jobs for its Qt Creator and its
+ *        settings directory and all their errors. Returns the number of failed installations.
+ */
+int reportInstallations(QTextStream &out, const QList<Installation> &installations,
+                        const QHash<QString, ProvisionResult> &colorSchemeResults,
+                        const QHash<QString, ProvisionResult> &settingsResults)
+{
+    int failedCount = 0;
+    foreach (const Installation &installation, installations) {
+        const ProvisionResult colorSchemeResult = colorSchemeResults.value(installation.uniqueResourcePath);
+        const ProvisionResult settingsResult = settingsResults.value(installation.uniqueSettingsPath);
+        const bool success = colorSchemeResult.success && settingsResult.success;
+
+        out << (success ? "ok     " : "failed ")
+            << (colorSchemeResult.elapsedTime + settingsResult.elapsedTime) / 1000 << " us  "
+            << installation.creatorPath << "  " << installation.settingsPath;
+        if (!success) {
+            out << "  " << (colorSchemeResult.messages + settingsResult.messages).join(QStringLiteral("; "));
+            ++failedCount;
+        }
+        out << endl;
+    }
+
+    return failedCount;
+}
+
+bool readInstallations(const QString &fileName, QList<Installation> *installations)
+{
+    QFile installationsFile(fileName);
+    if (!installationsFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    QTextStream stream(&installationsFile);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+            continue;
+
+        const QStringList paths = line.split(QLatin1Char('\t'), QString::SkipEmptyParts);
+        if (paths.count() != 2)
+            return false;
+
+        Installation installation;
+        installation.creatorPath = paths.at(0);
+        installation.settingsPath = paths.at(1);
+        installations->append(installation);
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("creatorstyleedit-provision"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Installs the CreatorStyleEdit color schemes into Qt Creator installations and "
+            "selects a style in their settings directories."));
+    parser.addHelpOption();
+    QCommandLineOption styleOption(QStringLiteral("style"),
+                                   QStringLiteral("Bundled style to select, or \"No Style\"."),
+                                   QStringLiteral("name"));
+    QCommandLineOption styleSheetOption(QStringLiteral("stylesheet"),
+                                        QStringLiteral("Custom stylesheet to select."),
+                                        QStringLiteral("file"));
+    QCommandLineOption installationsOption(QStringLiteral("installations"),
+                                           QStringLiteral("File with a tab separated Qt Creator "
+                                                          "and settings directory per line."),
+                                           QStringLiteral("file"));
+    QCommandLineOption jobsOption(QStringLiteral("jobs"),
+                                  QStringLiteral("Number of installations provisioned in parallel."),
+                                  QStringLiteral("count"));
+    parser.addOption(styleOption);
+    parser.addOption(styleSheetOption);
+    parser.addOption(installationsOption);
+    parser.addOption(jobsOption);
+    parser.addPositionalArgument(QStringLiteral("installation"),
+                                 QStringLiteral("Qt Creator directory and settings directory pairs."),
+                                 QStringLiteral("[<creator> <settings>...]"));
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QList<Installation> installations;
+    const QStringList positionalArguments = parser.positionalArguments();
+    if (positionalArguments.count() % 2 != 0) {
+        err << "Every Qt Creator directory needs a settings directory" << endl;
+        return 1;
+    }
+    for (int i = 0; i < positionalArguments.count(); i += 2) {
+        Installation installation;
+        installation.creatorPath = positionalArguments.at(i);
+        installation.settingsPath = positionalArguments.at(i + 1);
+        installations.append(installation);
+    }
+    if (parser.isSet(installationsOption)
+            && !readInstallations(parser.value(installationsOption), &installations)) {
+        err << "Can't read installations from " << parser.value(installationsOption) << endl;
+        return 1;
+    }
+    if (installations.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    SettingsWriter settingsWriter;
+    if (parser.isSet(styleSheetOption)) {
+        settingsWriter.selectedStyle = customStyleName;
+        settingsWriter.styleSheetPath = QFileInfo(parser.value(styleSheetOption)).absoluteFilePath();
+    } else if (parser.isSet(styleOption)) {
+        settingsWriter.selectedStyle = parser.value(styleOption);
+    } else {
+        settingsWriter.selectedStyle = noStyleName;
+    }
+
+    // Catch broken styles once here instead of at the first start of every installation
+    QString selectedStyleSheetPath = settingsWriter.styleSheetPath;
+    if (selectedStyleSheetPath.isEmpty() && settingsWriter.selectedStyle != noStyleName) {
+        selectedStyleSheetPath = StyleCatalog::bundledStyle(settingsWriter.selectedStyle).styleSheetPath;
+        if (selectedStyleSheetPath.isEmpty()) {
+            err << "Unknown style " << settingsWriter.selectedStyle << endl;
+            return 1;
+        }
+    }
+    const PreparedStyle preparedStyle = PreparedStyle::fromFile(selectedStyleSheetPath);
+    if (!preparedStyle.isValid()) {
+        err << "Can't use stylesheet " << selectedStyleSheetPath << ": "
+            << preparedStyle.errorString() << endl;
+        return 1;
+    }
+
+    if (parser.isSet(jobsOption))
+        QThreadPool::globalInstance()->setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+
+    // Installations may share a Qt Creator or a settings directory, so every directory is
+    // written by exactly one job
+    QStringList resourcePaths;
+    QStringList settingsPaths;
+    QSet<QString> knownResourcePaths;
+    QSet<QString> knownSettingsPaths;
+    for (int i = 0; i < installations.count(); ++i) {
+        Installation &installation = installations[i];
+        const QString resourcePath = uniquePath(creatorResourcePath(installation.creatorPath));
+        installation.uniqueResourcePath = resourcePath;
+        if (!knownResourcePaths.contains(resourcePath)) {
+            knownResourcePaths.insert(resourcePath);
+            resourcePaths.append(resourcePath);
+        }
+        const QString settingsPath = uniquePath(installation.settingsPath);
+        installation.uniqueSettingsPath = settingsPath;
+        if (!knownSettingsPaths.contains(settingsPath)) {
+            knownSettingsPaths.insert(settingsPath);
+            settingsPaths.append(settingsPath);
+        }
+    }
+
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+    const QList<ProvisionResult> colorSchemeResults
+            = QtConcurrent::blockingMapped<QList<ProvisionResult> >(resourcePaths, ColorSchemeInstaller());
+    const QList<ProvisionResult> settingsResults
+            = QtConcurrent::blockingMapped<QList<ProvisionResult> >(settingsPaths, settingsWriter);
+
+    QHash<QString, ProvisionResult> colorSchemeResultForPath;
+    foreach (const ProvisionResult &result, colorSchemeResults)
+        colorSchemeResultForPath.insert(result.path, result);
+    QHash<QString, ProvisionResult> settingsResultForPath;
+    foreach (const ProvisionResult &result, settingsResults)
+        settingsResultForPath.insert(result.path, result);
+
+    const int failedCount = reportInstallations(out, installations, colorSchemeResultForPath,
+                                                settingsResultForPath);
+    out << installations.count() << " installations, " << resourcePaths.count()
+        << " Qt Creator and " << settingsPaths.count() << " settings directories in "
+        << totalTimer.elapsed() << " ms, " << failedCount << " failed" << endl;
+
+    return failedCount == 0 ? 0 : 1;
+}
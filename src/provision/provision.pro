@@ -0,0 +1,26 @@
+# Command line tool that installs the CreatorStyleEdit styles into Qt Creator installations
+# and settings directories ahead of the first start. Built from the plugin sources that don't
+# depend on Qt Creator.
+
+QT += core gui concurrent
+QT -= widgets
+
+TARGET = creatorstyleedit-provision
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += main.cpp \
+    ../icontint.cpp \
+    ../preparedstyle.cpp \
+    ../stylecatalog.cpp
+
+HEADERS += ../icontint.h \
+    ../preparedstyle.h \
+    ../stylecatalog.h \
+    ../defines.h
+
+RESOURCES += \
+    ../styles/stlyes.qrc
@@ -0,0 +1,115 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "stylecatalog.h"
+
+using namespace CreatorStyleEdit::Internal;
+
+/*!
+ * \brief StyleCatalog::bundledStyles
+ *        Get all bundled styles that have a colorscheme, a stylesheet and a readme file
+ */
+QList<StyleInfo> StyleCatalog::bundledStyles()
+{
+    QList<StyleInfo> styles;
+
+    QDir stylesBaseDir(QStringLiteral(":/CreatorStyleEdit/styles/"));
+    foreach (const QFileInfo styleInfo, stylesBaseDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        StyleInfo style;
+        style.name = styleInfo.fileName();
+
+        QDir styleDir = styleInfo.absoluteFilePath();
+        foreach (const QFileInfo styleFile, styleDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot)) {
+            if (styleFile.fileName().endsWith(QStringLiteral(".xml"))) {
+                style.colorSchemePath = styleFile.absoluteFilePath();
+            }
+            if (styleFile.fileName().endsWith(QStringLiteral(".css"))) {
+                style.styleSheetPath = styleFile.absoluteFilePath();
+            }
+            if (styleFile.fileName().toLower().contains(QStringLiteral("readme"))) {
+                style.readmePath = styleFile.absoluteFilePath();
+            }
+        }
+
+        if (style.colorSchemePath.isEmpty()) {
+            qWarning() << "Style " << style.name << " has no colorscheme file";
+            continue;
+        }
+        if (style.styleSheetPath.isEmpty()) {
+            qWarning() << "Style " << style.name << " has no stylesheet file";
+            continue;
+        }
+        if (style.readmePath.isEmpty()) {
+            qWarning() << "Style " << style.name << " has no readme file";
+            continue;
+        }
+
+        styles.append(style);
+    }
+
+    return styles;
+}
+
+/*!
+ * \brief StyleCatalog::bundledStyle
+ *        Get the bundled style with the name, the style has no name if it doesn't exist
+ */
+StyleInfo StyleCatalog::bundledStyle(const QString &name)
+{
+    foreach (const StyleInfo &style, bundledStyles()) {
+        if (style.name == name)
+            return style;
+    }
+
+    return StyleInfo();
+}
+
+/*!
+ * \brief StyleCatalog::installColorScheme
+ *        Export the color scheme file of the style to the styles directory of a Qt Creator
+ *        installation. An up to date color scheme isn't written again.
+ */
+bool StyleCatalog::installColorScheme(const StyleInfo &style, const QString &resourcePath,
+                                      QString *errorString)
+{
+    QDir colorSchemesDir(resourcePath + QLatin1String("/styles"));
+    QString colorSchemeFileName = QFileInfo(style.colorSchemePath).fileName();
+    QFile sourceSchemeFile(style.colorSchemePath);
+    QFile destSchemeFile(colorSchemesDir.absoluteFilePath(colorSchemeFileName));
+
+    if (!sourceSchemeFile.open(QIODevice::ReadOnly)) {
+        if (errorString)
+            *errorString = sourceSchemeFile.errorString();
+        return false;
+    }
+    const QByteArray colorScheme = sourceSchemeFile.readAll();
+    sourceSchemeFile.close();
+
+    if (destSchemeFile.size() == colorScheme.size() && destSchemeFile.open(QIODevice::ReadOnly)) {
+        const bool upToDate = destSchemeFile.readAll() == colorScheme;
+        destSchemeFile.close();
+        if (upToDate)
+            return true;
+    }
+
+    // Doesn't use QFile::copy, because destination file will be read only
+    if (!destSchemeFile.open(QIODevice::WriteOnly)) {
+        if (errorString)
+            *errorString = destSchemeFile.errorString();
+        return false;
+    }
+    destSchemeFile.write(colorScheme);
+    destSchemeFile.close();
+
+    return true;
+}
@@ -0,0 +1,42 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef STYLECATALOG_H
+#define STYLECATALOG_H
+
+#include <QList>
+#include <QString>
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+struct StyleInfo {
+    QString name;
+    QString styleSheetPath;
+    QString colorSchemePath;
+    QString readmePath;
+};
+
+/*!
+ * \brief The StyleCatalog class
+ *        Styles that are bundled with the plugin. Doesn't depend on Qt Creator, so it can be
+ *        used by the provisioning tool as well.
+ */
+class StyleCatalog
+{
+public:
+    static QList<StyleInfo> bundledStyles();
+    static StyleInfo bundledStyle(const QString &name);
+    static bool installColorScheme(const StyleInfo &style, const QString &resourcePath,
+                                   QString *errorString = 0);
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // STYLECATALOG_H
@@ -17,6 +17,7 @@
 #include <coreplugin/icore.h>
 
 #include "defines.h"
+#include "stylecatalog.h"
 #include "styleeditor.h"
 
 using namespace CreatorStyleEdit::Internal;
@@ -57,56 +58,19 @@ StyleEditor::StyleEditor(QWidget *parent) :
 
 void StyleEditor::initStyleListView()
 {
-    QDir stylesBaseDir(QStringLiteral(":/CreatorStyleEdit/styles/"));
-    foreach (const QFileInfo styleInfo, stylesBaseDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
-        QString styleName = styleInfo.fileName();
-
-        QString colorSchemePath;
-        QString stylesheetPath;
-        QString readmePath;
-        QDir styleDir = styleInfo.absoluteFilePath();
-        foreach (const QFileInfo styleFile, styleDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot)) {
-            if (styleFile.fileName().endsWith(QStringLiteral(".xml"))) {
-                colorSchemePath = styleFile.absoluteFilePath();
-            }
-            if (styleFile.fileName().endsWith(QStringLiteral(".css"))) {
-                stylesheetPath = styleFile.absoluteFilePath();
-            }
-            if (styleFile.fileName().toLower().contains(QStringLiteral("readme"))) {
-                readmePath = styleFile.absoluteFilePath();
-            }
-        }
-
-        if (colorSchemePath.isEmpty()) {
-            qWarning() << "Style " << styleName << " has no colorscheme file";
-            continue;
-        }
-        if (stylesheetPath.isEmpty()) {
-            qWarning() << "Style " << styleName << " has no stylesheet file";
-            continue;
-        }
-        if (readmePath.isEmpty()) {
-            qWarning() << "Style " << styleName << " has no readme file";
-            continue;
+    QString resourcePath = Core::ICore::resourcePath();
+    foreach (const StyleInfo &style, StyleCatalog::bundledStyles()) {
+        // Export color scheme file to Qt Creator install dir
+        QString errorString;
+        if (!StyleCatalog::installColorScheme(style, resourcePath, &errorString)) {
+            qWarning() << "Could not install color scheme of style " << style.name << ": "
+                       << errorString;
         }
 
-        // Export color scheme file to Qt Creator install dir
-        QString resourcePath = Core::ICore::resourcePath();
-        QDir colorSchemesDir(resourcePath + QLatin1String("/styles"));
-        QString colorSchemeFileName = QFileInfo(colorSchemePath).fileName();
-        QFile sourceSchemeFile(colorSchemePath);
-        QFile destSchemeFile(colorSchemesDir.absoluteFilePath(colorSchemeFileName));
-        // Doesn't use QFile::copy, because destination file will be read only
-        sourceSchemeFile.open(QIODevice::ReadOnly);
-        destSchemeFile.open(QIODevice::WriteOnly);
-        destSchemeFile.write(sourceSchemeFile.readAll());
-        sourceSchemeFile.close();
-        destSchemeFile.close();
-
-        QListWidgetItem *styleItem = new QListWidgetItem(styleName);
-        styleItem->setData(CssFile, stylesheetPath);
-        styleItem->setData(ColorSchemeFile, colorSchemePath);
-        QFile readmeFile(readmePath);
+        QListWidgetItem *styleItem = new QListWidgetItem(style.name);
+        styleItem->setData(CssFile, style.styleSheetPath);
+        styleItem->setData(ColorSchemeFile, style.colorSchemePath);
+        QFile readmeFile(style.readmePath);
         readmeFile.open(QIODevice::ReadOnly);
         styleItem->setData(ReadmeFile, QString::fromUtf8(readmeFile.readAll()));
         readmeFile.close();
@@ -164,6 +128,21 @@ QString StyleEditor::customStyleSheetPath() const
     return ui->stylesheetPathLineEdit->text();
 }
 
+QStringList StyleEditor::styleNames() const
+{
+    QStringList names;
+    for (int row = 0; row < ui->styleListWidget->count(); ++row) {
+        names.append(ui->styleListWidget->item(row)->text());
+    }
+
+    return names;
+}
+
+QString StyleEditor::customStyleName() const
+{
+    return m_customStyleItem->text();
+}
+
 void StyleEditor::buttonClicked(QAbstractButton *button)
 {
     QDialogButtonBox::ButtonRole buttonRole = ui->buttonBox->buttonRole(button);
@@ -199,7 +178,7 @@ void StyleEditor::currentStyleListItemChanged(QListWidgetItem *current, QListWid
         ui->exportPushButton->setEnabled(false);
         ui->styleDescriptionTextEdit->setText(tr("<h3>No style sheet</h3>"
                                                  "<p>No style sheet will be set for Qt Creator. "
-                                                 "Restart required.</p>"));
+                                                 "The native style is restored.</p>"));
         m_currentStyleSheetPath.clear();
     } else if (current == m_customStyleItem) {
         ui->exportPushButton->setEnabled(false);
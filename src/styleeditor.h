@@ -31,6 +31,8 @@ public:
     QString selectedStyle() const;
     QString styleSheetPath() const;
     QString customStyleSheetPath() const;
+    QStringList styleNames() const;
+    QString customStyleName() const;
 
 signals:
     void stylesheetChanged();
@@ -0,0 +1,103 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtConcurrentRun>
+
+#include "stylepipeline.h"
+
+using namespace CreatorStyleEdit::Internal;
+
+StylePipeline::StylePipeline(QObject *parent) :
+    QObject(parent),
+    m_prepareWatcher(new QFutureWatcher<PreparedStyle>(this)),
+    m_hasPendingStyleSheet(false),
+    m_busy(false),
+    m_lastCommitTime(0)
+{
+    connect(m_prepareWatcher, &QFutureWatcher<PreparedStyle>::finished,
+            this, &StylePipeline::prepareFinished);
+}
+
+StylePipeline::~StylePipeline()
+{
+    m_prepareWatcher->waitForFinished();
+}
+
+void StylePipeline::setCommitFunction(const CommitFunction &commitFunction)
+{
+    m_commitFunction = commitFunction;
+}
+
+/*!
+ * \brief StylePipeline::apply
+ *        Prepare the stylesheet in the background and commit it afterwards.
+ *        An empty path commits a style that removes the current one.
+ */
+void StylePipeline::apply(const QString &styleSheetPath)
+{
+    if (m_busy) {
+        m_pendingStyleSheetPath = styleSheetPath;
+        m_hasPendingStyleSheet = true;
+        return;
+    }
+
+    startPrepare(styleSheetPath);
+}
+
+/*!
+ * \brief StylePipeline::isBusy
+ *        True until the newest requested style is committed
+ */
+bool StylePipeline::isBusy() const
+{
+    return m_busy;
+}
+
+/*!
+ * \brief StylePipeline::lastCommitTime
+ *        Time in nanoseconds the GUI thread spent in the last commit stage
+ */
+qint64 StylePipeline::lastCommitTime() const
+{
+    return m_lastCommitTime;
+}
+
+void StylePipeline::startPrepare(const QString &styleSheetPath)
+{
+    m_busy = true;
+    m_prepareWatcher->setFuture(QtConcurrent::run(&PreparedStyle::fromFile, styleSheetPath));
+}
+
+void StylePipeline::prepareFinished()
+{
+    // A newer style was requested in the meantime, so this one is outdated
+    if (m_hasPendingStyleSheet) {
+        m_hasPendingStyleSheet = false;
+        startPrepare(m_pendingStyleSheetPath);
+        return;
+    }
+
+    const PreparedStyle style = m_prepareWatcher->result();
+    if (!style.isValid()) {
+        qWarning() << "CreatorStyleEdit: can't apply stylesheet" << style.path() << ":"
+                   << style.errorString();
+        m_busy = false;
+        return;
+    }
+
+    QElapsedTimer commitTimer;
+    commitTimer.start();
+    if (m_commitFunction)
+        m_commitFunction(style);
+    m_lastCommitTime = commitTimer.nsecsElapsed();
+
+    m_busy = false;
+    emit committed(m_lastCommitTime);
+}
@@ -0,0 +1,64 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef STYLEPIPELINE_H
+#define STYLEPIPELINE_H
+
+#include <QObject>
+#include <QFutureWatcher>
+
+#include <functional>
+
+#include "preparedstyle.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The StylePipeline class
+ *        Applies a stylesheet in two stages. The prepare stage reads and preprocesses the
+ *        stylesheet on a worker thread, the commit stage hands the prepared style to the
+ *        widgets on the GUI thread. If a new style is requested while one is prepared, only
+ *        the newest one gets committed.
+ */
+class StylePipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<void (const PreparedStyle &)> CommitFunction;
+
+    explicit StylePipeline(QObject *parent = 0);
+    ~StylePipeline();
+
+    void setCommitFunction(const CommitFunction &commitFunction);
+    void apply(const QString &styleSheetPath);
+    bool isBusy() const;
+    qint64 lastCommitTime() const;
+
+signals:
+    void committed(qint64 commitTime);
+
+private slots:
+    void prepareFinished();
+
+private:
+    void startPrepare(const QString &styleSheetPath);
+
+    QFutureWatcher<PreparedStyle> *m_prepareWatcher;
+    CommitFunction m_commitFunction;
+    QString m_pendingStyleSheetPath;
+    bool m_hasPendingStyleSheet;
+    bool m_busy;
+    qint64 m_lastCommitTime;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // STYLEPIPELINE_H
@@ -0,0 +1,369 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QApplication>
+#include <QDockWidget>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMainWindow>
+#include <QPlainTextEdit>
+#include <QSplitter>
+#include <QStackedWidget>
+#include <QTextStream>
+#include <QTreeWidget>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+#include "processmemory.h"
+#include "styleeditor.h"
+#include "stylepipeline.h"
+#include "stylesoakrunner.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+static const int syntheticViewItemCount = 200;
+static const int syntheticDockCount = 4;
+static const char syntheticWindowObjectName[] = "StyleSoakSyntheticWindow";
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+using namespace CreatorStyleEdit::Internal;
+
+StyleSoakRunner::StyleSoakRunner(StyleEditor *styleEditor, StylePipeline *stylePipeline,
+                                 QObject *parent) :
+    QObject(parent),
+    m_styleEditor(styleEditor),
+    m_stylePipeline(stylePipeline),
+    m_syntheticWindow(0),
+    m_cycles(100),
+    m_maximumMemoryGrowth(16 * 1024 * 1024),
+    m_maximumSlowdown(50),
+    m_maximumWidgetGrowth(100)
+{
+}
+
+StyleSoakRunner::~StyleSoakRunner()
+{
+    delete m_syntheticWindow;
+}
+
+void StyleSoakRunner::setCycles(int cycles)
+{
+    m_cycles = cycles;
+}
+
+int StyleSoakRunner::cycles() const
+{
+    return m_cycles;
+}
+
+void StyleSoakRunner::setCustomStyleSheetPaths(const QStringList &paths)
+{
+    m_customStyleSheetPaths = paths;
+}
+
+void StyleSoakRunner::setMaximumMemoryGrowth(qint64 bytes)
+{
+    m_maximumMemoryGrowth = bytes;
+}
+
+void StyleSoakRunner::setMaximumSlowdown(int percent)
+{
+    m_maximumSlowdown = percent;
+}
+
+/*!
+ * \brief StyleSoakRunner::setMaximumWidgetGrowth
+ *        Qt Creator creates some widgets lazily, so a few more widgets at the end of the soak
+ *        don't mean that a switch leaks
+ */
+void StyleSoakRunner::setMaximumWidgetGrowth(int widgets)
+{
+    m_maximumWidgetGrowth = widgets;
+}
+
+/*!
+ * \brief StyleSoakRunner::syntheticWindowName
+ *        Object name of the synthetic window. The plugin styles it like its other targets.
+ */
+QString StyleSoakRunner::syntheticWindowName()
+{
+    return QLatin1String(syntheticWindowObjectName);
+}
+
+/*!
+ * \brief StyleSoakRunner::run
+ *        Runs all soak cycles and restores the previously selected style afterwards.
+ *        Returns false if one of the growth thresholds was exceeded.
+ */
+bool StyleSoakRunner::run()
+{
+    m_samples.clear();
+    m_summary.clear();
+    m_failures.clear();
+
+    const QString originalStyle = m_styleEditor->selectedStyle();
+    const QString originalCustomStyleSheetPath = m_styleEditor->customStyleSheetPath();
+    const QList<Step> soakSteps = steps();
+
+    createSyntheticWidgetTree();
+
+    QElapsedTimer switchTimer;
+    for (int cycle = 0; cycle < m_cycles; ++cycle) {
+        foreach (const Step &step, soakSteps) {
+            switchTimer.start();
+            switchTo(step);
+            // Widgets and styles replaced by the switch are deleted later, so let the event
+            // loop delete them before counting to not report them as leaks
+            QCoreApplication::processEvents();
+
+            Sample sample;
+            sample.cycle = cycle;
+            sample.styleName = step.customStyleSheetPath.isEmpty() ? step.styleName
+                                                                   : step.customStyleSheetPath;
+            sample.switchTime = switchTimer.nsecsElapsed();
+            sample.commitTime = m_stylePipeline->lastCommitTime();
+            sample.residentMemory = processResidentMemory();
+            sample.widgetCount = QApplication::allWidgets().count();
+            m_samples.append(sample);
+        }
+
+        QCoreApplication::processEvents();
+    }
+
+    delete m_syntheticWindow;
+    m_syntheticWindow = 0;
+
+    m_styleEditor->setCustomStyleSheetPath(originalCustomStyleSheetPath);
+    m_styleEditor->setSelectedStyle(originalStyle);
+
+    evaluate();
+
+    return m_failures.isEmpty();
+}
+
+QStringList StyleSoakRunner::report() const
+{
+    return m_summary + m_failures;
+}
+
+/*!
+ * \brief StyleSoakRunner::writeReport
+ *        Write all recorded samples as comma separated values
+ */
+bool StyleSoakRunner::writeReport(const QString &fileName) const
+{
+    QFile reportFile(fileName);
+    if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream stream(&reportFile);
+    stream << "cycle,style,switch_us,commit_us,resident_kb,widgets\n";
+    foreach (const Sample &sample, m_samples) {
+        stream << sample.cycle << ','
+               << sample.styleName << ','
+               << sample.switchTime / 1000 << ','
+               << sample.commitTime / 1000 << ','
+               << sample.residentMemory / 1024 << ','
+               << sample.widgetCount << '\n';
+    }
+
+    reportFile.close();
+    return true;
+}
+
+QList<StyleSoakRunner::Step> StyleSoakRunner::steps() const
+{
+    QList<Step> soakSteps;
+
+    const QString customStyleName = m_styleEditor->customStyleName();
+    foreach (const QString &styleName, m_styleEditor->styleNames()) {
+        if (styleName == customStyleName)
+            continue;
+
+        Step step;
+        step.styleName = styleName;
+        soakSteps.append(step);
+    }
+
+    foreach (const QString &path, m_customStyleSheetPaths) {
+        Step step;
+        step.styleName = customStyleName;
+        step.customStyleSheetPath = path;
+        soakSteps.append(step);
+    }
+
+    return soakSteps;
+}
+
+void StyleSoakRunner::switchTo(const Step &step)
+{
+    if (!step.customStyleSheetPath.isEmpty())
+        m_styleEditor->setCustomStyleSheetPath(step.customStyleSheetPath);
+
+    m_styleEditor->setSelectedStyle(step.styleName);
+
+    // The style is prepared in the background and committed to the synthetic window by the
+    // plugin together with all other targets, so wait until it is committed
+    while (m_stylePipeline->isBusy())
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+}
+
+/*!
+ * \brief StyleSoakRunner::createSyntheticWidgetTree
+ *        Create a hidden window that resembles the widgets styled inside of Qt Creator:
+ *        navigation views, the stacked output pane widget and debugger dock widgets. The plugin
+ *        collects the window as a style target, so every switch goes through the same commit
+ *        path as the widgets of Qt Creator.
+ */
+void StyleSoakRunner::createSyntheticWidgetTree()
+{
+    delete m_syntheticWindow;
+
+    m_syntheticWindow = new QMainWindow;
+    m_syntheticWindow->setObjectName(syntheticWindowName());
+    m_syntheticWindow->setAttribute(Qt::WA_DontShowOnScreen);
+
+    QSplitter *splitter = new QSplitter(Qt::Horizontal);
+
+    QWidget *navigationWidget = new QWidget;
+    QVBoxLayout *navigationLayout = new QVBoxLayout(navigationWidget);
+    QTreeWidget *projectTree = new QTreeWidget;
+    QListWidget *openDocumentsList = new QListWidget;
+    for (int i = 0; i < syntheticViewItemCount; ++i) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(projectTree);
+        item->setText(0, QString(QStringLiteral("file%1.cpp")).arg(i));
+        openDocumentsList->addItem(QString(QStringLiteral("document%1.h")).arg(i));
+    }
+    navigationLayout->addWidget(projectTree);
+    navigationLayout->addWidget(openDocumentsList);
+    splitter->addWidget(navigationWidget);
+
+    QStackedWidget *outputPaneWidget = new QStackedWidget;
+    outputPaneWidget->setObjectName(QStringLiteral("OutputPaneManagerMainWidget"));
+    for (int i = 0; i < 4; ++i) {
+        QPlainTextEdit *outputEdit = new QPlainTextEdit;
+        outputEdit->setPlainText(QString(QStringLiteral("Output pane %1")).arg(i));
+        outputPaneWidget->addWidget(outputEdit);
+    }
+    splitter->addWidget(outputPaneWidget);
+
+    m_syntheticWindow->setCentralWidget(splitter);
+
+    for (int i = 0; i < syntheticDockCount; ++i) {
+        QDockWidget *dockWidget = new QDockWidget(QString(QStringLiteral("Dock %1")).arg(i));
+        QTreeWidget *dockTree = new QTreeWidget;
+        for (int j = 0; j < syntheticViewItemCount; ++j) {
+            QTreeWidgetItem *item = new QTreeWidgetItem(dockTree);
+            item->setText(0, QString(QStringLiteral("variable%1")).arg(j));
+        }
+        dockWidget->setWidget(dockTree);
+        m_syntheticWindow->addDockWidget(Qt::BottomDockWidgetArea, dockWidget);
+    }
+
+    m_syntheticWindow->resize(1200, 800);
+    m_syntheticWindow->show();
+}
+
+/*!
+ * \brief StyleSoakRunner::evaluate
+ *        Compare the first cycles after the warm up cycle with the last cycles.
+ *        The first cycle is not taken into account, because it fills all caches.
+ */
+void StyleSoakRunner::evaluate()
+{
+    if (m_samples.isEmpty()) {
+        m_failures.append(tr("Style soak: no styles to switch"));
+        return;
+    }
+
+    qint64 totalSwitchTime = 0;
+    qint64 maximumSwitchTime = 0;
+    foreach (const Sample &sample, m_samples) {
+        totalSwitchTime += sample.switchTime;
+        maximumSwitchTime = qMax(maximumSwitchTime, sample.switchTime);
+    }
+
+    m_summary.append(tr("Style soak: %1 cycles, %2 switches, mean switch %3 us, max switch %4 us")
+                     .arg(m_cycles)
+                     .arg(m_samples.count())
+                     .arg(totalSwitchTime / m_samples.count() / 1000)
+                     .arg(maximumSwitchTime / 1000));
+
+    if (m_cycles < 3) {
+        m_summary.append(tr("Style soak: at least 3 cycles are required to measure growth"));
+        return;
+    }
+
+    const int windowCycles = qMax(1, (m_cycles - 1) / 10);
+    const QList<Sample> firstWindow = samplesOfCycles(1, windowCycles);
+    const QList<Sample> lastWindow = samplesOfCycles(m_cycles - windowCycles, m_cycles - 1);
+
+    QVector<qint64> firstMemory, lastMemory, firstLatency, lastLatency;
+    foreach (const Sample &sample, firstWindow) {
+        firstMemory.append(sample.residentMemory);
+        firstLatency.append(sample.switchTime);
+    }
+    foreach (const Sample &sample, lastWindow) {
+        lastMemory.append(sample.residentMemory);
+        lastLatency.append(sample.switchTime);
+    }
+
+    const qint64 memoryGrowth = median(lastMemory) - median(firstMemory);
+    const int widgetGrowth = lastWindow.last().widgetCount - firstWindow.last().widgetCount;
+    const qint64 firstMedianLatency = qMax(Q_INT64_C(1), median(firstLatency));
+    const qint64 lastMedianLatency = median(lastLatency);
+    const qint64 slowdown = (lastMedianLatency - firstMedianLatency) * 100 / firstMedianLatency;
+
+    m_summary.append(tr("Style soak: resident memory growth %1 KiB, widget growth %2, "
+                        "median switch %3 us -> %4 us")
+                     .arg(memoryGrowth / 1024)
+                     .arg(widgetGrowth)
+                     .arg(firstMedianLatency / 1000)
+                     .arg(lastMedianLatency / 1000));
+
+    if (firstWindow.first().residentMemory >= 0 && memoryGrowth > m_maximumMemoryGrowth) {
+        m_failures.append(tr("Style soak failed: resident memory grew by %1 KiB, allowed %2 KiB")
+                          .arg(memoryGrowth / 1024)
+                          .arg(m_maximumMemoryGrowth / 1024));
+    }
+    if (widgetGrowth > m_maximumWidgetGrowth) {
+        m_failures.append(tr("Style soak failed: %1 widgets leaked, allowed %2")
+                          .arg(widgetGrowth)
+                          .arg(m_maximumWidgetGrowth));
+    }
+    if (slowdown > m_maximumSlowdown) {
+        m_failures.append(tr("Style soak failed: switching slowed down by %1%, allowed %2%")
+                          .arg(slowdown)
+                          .arg(m_maximumSlowdown));
+    }
+}
+
+QList<StyleSoakRunner::Sample> StyleSoakRunner::samplesOfCycles(int firstCycle, int lastCycle) const
+{
+    QList<Sample> samples;
+    foreach (const Sample &sample, m_samples) {
+        if (sample.cycle >= firstCycle && sample.cycle <= lastCycle)
+            samples.append(sample);
+    }
+
+    return samples;
+}
+
+qint64 StyleSoakRunner::median(QVector<qint64> values)
+{
+    if (values.isEmpty())
+        return 0;
+
+    std::sort(values.begin(), values.end());
+    return values.at(values.count() / 2);
+}
@@ -0,0 +1,89 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef STYLESOAKRUNNER_H
+#define STYLESOAKRUNNER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+class QMainWindow;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+class StyleEditor;
+class StylePipeline;
+
+/*!
+ * \brief The StyleSoakRunner class
+ *        Switches between all styles of the style editor and a set of custom stylesheets
+ *        many times and records resident memory, widget count and latency of every switch.
+ *        The run fails if memory, widget count or latency grows beyond the set thresholds.
+ */
+class StyleSoakRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    StyleSoakRunner(StyleEditor *styleEditor, StylePipeline *stylePipeline, QObject *parent = 0);
+    ~StyleSoakRunner();
+
+    void setCycles(int cycles);
+    int cycles() const;
+    void setCustomStyleSheetPaths(const QStringList &paths);
+    void setMaximumMemoryGrowth(qint64 bytes);
+    void setMaximumSlowdown(int percent);
+    void setMaximumWidgetGrowth(int widgets);
+
+    static QString syntheticWindowName();
+
+    bool run();
+    QStringList report() const;
+    bool writeReport(const QString &fileName) const;
+
+private:
+    struct Step {
+        QString styleName;
+        QString customStyleSheetPath;
+    };
+
+    struct Sample {
+        int cycle;
+        QString styleName;
+        qint64 switchTime;
+        qint64 commitTime;
+        qint64 residentMemory;
+        int widgetCount;
+    };
+
+    QList<Step> steps() const;
+    void switchTo(const Step &step);
+    void createSyntheticWidgetTree();
+    void evaluate();
+    QList<Sample> samplesOfCycles(int firstCycle, int lastCycle) const;
+    static qint64 median(QVector<qint64> values);
+
+    StyleEditor *m_styleEditor;
+    StylePipeline *m_stylePipeline;
+    QMainWindow *m_syntheticWindow;
+    QStringList m_customStyleSheetPaths;
+    int m_cycles;
+    qint64 m_maximumMemoryGrowth;
+    int m_maximumSlowdown;
+    int m_maximumWidgetGrowth;
+    QList<Sample> m_samples;
+    QStringList m_summary;
+    QStringList m_failures;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // STYLESOAKRUNNER_H
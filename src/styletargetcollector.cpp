@@ -0,0 +1,115 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QApplication>
+#include <QVector>
+#include <QWidget>
+
+#include "styletargetcollector.h"
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+static const char navigationWidgetClassName[] = "Core::NavigationWidget";
+static const char outputPaneManagerClassName[] = "Core::Internal::OutputPaneManager";
+static const char debuggerMainWindowClassName[] = "Debugger::DebuggerMainWindow";
+static const char dockWidgetClassName[] = "QDockWidget";
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+using namespace CreatorStyleEdit::Internal;
+
+StyleTargetCollector::StyleTargetCollector(const ThemeMapping &themeMapping) :
+    m_themeMapping(themeMapping),
+    m_visitedWidgetCount(0),
+    m_topLevelWidgetCount(0)
+{
+}
+
+/*!
+ * \brief StyleTargetCollector::themeMapping
+ *        The widgets of Qt Creator that get the stylesheet. Dock widgets are targets inside of
+ *        debugger main windows only. The main window creates them as subclasses of QDockWidget.
+ */
+ThemeMapping StyleTargetCollector::themeMapping()
+{
+    ThemeMapping mapping;
+    mapping.addRule(NavigationTarget, navigationWidgetClassName);
+    mapping.addRule(OutputPaneTarget, outputPaneManagerClassName);
+    mapping.addRule(DebuggerDockTarget, dockWidgetClassName, ThemeMapping::InheritedClass,
+                    debuggerMainWindowClassName);
+    return mapping;
+}
+
+/*!
+ * \brief StyleTargetCollector::collect
+ *        Traverse all top level widgets once. The subtrees of found targets are skipped,
+ *        because targets are never nested, and child windows are visited as top level widgets
+ *        only.
+ */
+void StyleTargetCollector::collect()
+{
+    for (int kind = 0; kind < TargetKindCount; ++kind)
+        m_targets[kind].clear();
+    m_visitedWidgetCount = 0;
+
+    const QWidgetList topLevelWidgets = QApplication::topLevelWidgets();
+    m_topLevelWidgetCount = topLevelWidgets.count();
+
+    QVector<QWidget *> pendingWidgets;
+    foreach (QWidget *topLevelWidget, topLevelWidgets)
+        pendingWidgets.append(topLevelWidget);
+
+    while (!pendingWidgets.isEmpty()) {
+        QWidget *widget = pendingWidgets.takeLast();
+        ++m_visitedWidgetCount;
+
+        const int kind = m_themeMapping.targetKind(widget);
+        if (kind >= 0) {
+            m_targets[kind].append(widget);
+            continue;
+        }
+
+        // Child windows like menus, dialogs and floating docks are top level widgets themselves
+        foreach (QObject *childObject, widget->children()) {
+            if (!childObject->isWidgetType())
+                continue;
+
+            QWidget *childWidget = static_cast<QWidget *>(childObject);
+            if (!childWidget->isWindow())
+                pendingWidgets.append(childWidget);
+        }
+    }
+}
+
+QList<QWidget *> StyleTargetCollector::targets(TargetKind kind) const
+{
+    return m_targets[kind];
+}
+
+int StyleTargetCollector::visitedWidgetCount() const
+{
+    return m_visitedWidgetCount;
+}
+
+int StyleTargetCollector::topLevelWidgetCount() const
+{
+    return m_topLevelWidgetCount;
+}
+
+QString StyleTargetCollector::coverageReport() const
+{
+    return QString(QStringLiteral("%1 navigation widgets, %2 output panes, %3 debugger docks "
+                                  "in %4 top level widgets, %5 widgets visited"))
+            .arg(m_targets[NavigationTarget].count())
+            .arg(m_targets[OutputPaneTarget].count())
+            .arg(m_targets[DebuggerDockTarget].count())
+            .arg(m_topLevelWidgetCount)
+            .arg(m_visitedWidgetCount);
+}
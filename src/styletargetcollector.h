@@ -0,0 +1,58 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef STYLETARGETCOLLECTOR_H
+#define STYLETARGETCOLLECTOR_H
+
+#include <QList>
+#include <QString>
+
+#include "thememapping.h"
+
+class QWidget;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The StyleTargetCollector class
+ *        Collects all widgets that get the stylesheet in a single traversal of all top level
+ *        windows. Widgets are matched by the rules of the theme mapping.
+ */
+class StyleTargetCollector
+{
+public:
+    enum TargetKind {
+        NavigationTarget,
+        OutputPaneTarget,
+        DebuggerDockTarget,
+        TargetKindCount
+    };
+
+    explicit StyleTargetCollector(const ThemeMapping &themeMapping);
+
+    static ThemeMapping themeMapping();
+
+    void collect();
+
+    QList<QWidget *> targets(TargetKind kind) const;
+    int visitedWidgetCount() const;
+    int topLevelWidgetCount() const;
+    QString coverageReport() const;
+
+private:
+    ThemeMapping m_themeMapping;
+    QList<QWidget *> m_targets[TargetKindCount];
+    int m_visitedWidgetCount;
+    int m_topLevelWidgetCount;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // STYLETARGETCOLLECTOR_H
@@ -0,0 +1,96 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QWidget>
+
+#include "thememapping.h"
+
+using namespace CreatorStyleEdit::Internal;
+
+ThemeMapping::ThemeMapping() :
+    d(new Data)
+{
+}
+
+/*!
+ * \brief ThemeMapping::addRule
+ *        Map widgets of the class to the target kind. With InheritedClass widgets of derived
+ *        classes match as well. An empty parent class name or object name matches every widget
+ *        of the class. Rules are tried in the order they were added.
+ */
+void ThemeMapping::addRule(int targetKind, const QByteArray &className, ClassMatch classMatch,
+                           const QByteArray &parentClassName, const QString &objectName)
+{
+    Rule rule;
+    rule.targetKind = targetKind;
+    rule.className = className;
+    rule.classMatch = classMatch;
+    rule.parentClassName = parentClassName;
+    rule.objectName = objectName;
+    d->rules.append(rule);
+    d->rulesForMetaObject.clear();
+}
+
+bool ThemeMapping::isEmpty() const
+{
+    return d->rules.isEmpty();
+}
+
+/*!
+ * \brief ThemeMapping::targetKind
+ *        The target kind of the first matching rule, or -1 if the widget isn't a style target
+ */
+int ThemeMapping::targetKind(const QWidget *widget) const
+{
+    foreach (const Rule &rule, rulesForClass(widget->metaObject())) {
+        if (!rule.parentClassName.isEmpty()) {
+            const QWidget *parentWidget = widget->parentWidget();
+            if (!parentWidget
+                    || rule.parentClassName != parentWidget->metaObject()->className()) {
+                continue;
+            }
+        }
+        if (!rule.objectName.isEmpty() && rule.objectName != widget->objectName())
+            continue;
+
+        return rule.targetKind;
+    }
+
+    return -1;
+}
+
+/*!
+ * \brief ThemeMapping::rulesForClass
+ *        The rules that can match widgets of the class. They are compiled once per meta object
+ *        to not compare the class names of the class and its base classes for every widget.
+ */
+const QVector<ThemeMapping::Rule> &ThemeMapping::rulesForClass(const QMetaObject *metaObject) const
+{
+    const Data *data = d.constData();
+    QHash<const QMetaObject *, QVector<Rule> >::const_iterator it = data->rulesForMetaObject.constFind(metaObject);
+    if (it != data->rulesForMetaObject.constEnd())
+        return it.value();
+
+    QVector<Rule> rules;
+    foreach (const Rule &rule, data->rules) {
+        if (rule.classMatch == ExactClass) {
+            if (rule.className == metaObject->className())
+                rules.append(rule);
+            continue;
+        }
+
+        for (const QMetaObject *superClass = metaObject; superClass; superClass = superClass->superClass()) {
+            if (rule.className == superClass->className()) {
+                rules.append(rule);
+                break;
+            }
+        }
+    }
+
+    return data->rulesForMetaObject.insert(metaObject, rules).value();
+}
@@ -0,0 +1,72 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef THEMEMAPPING_H
+#define THEMEMAPPING_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QString>
+#include <QVector>
+
+class QMetaObject;
+class QWidget;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The ThemeMapping class
+ *        Maps widgets to the style target they belong to. Rules match the exact class name of a
+ *        widget or one of its base classes, and optionally the class name of its parent widget
+ *        and its object name. The rules of a class are compiled once per meta object, so
+ *        matching a widget costs the same no matter how many widgets exist. Copies share the
+ *        rules and the compiled classes until rules are added to one of them.
+ */
+class ThemeMapping
+{
+public:
+    enum ClassMatch {
+        ExactClass,
+        InheritedClass
+    };
+
+    ThemeMapping();
+
+    void addRule(int targetKind, const QByteArray &className, ClassMatch classMatch = ExactClass,
+                 const QByteArray &parentClassName = QByteArray(),
+                 const QString &objectName = QString());
+    bool isEmpty() const;
+
+    int targetKind(const QWidget *widget) const;
+
+private:
+    struct Rule {
+        int targetKind;
+        QByteArray className;
+        ClassMatch classMatch;
+        QByteArray parentClassName;
+        QString objectName;
+    };
+
+    struct Data : public QSharedData {
+        QVector<Rule> rules;
+        mutable QHash<const QMetaObject *, QVector<Rule> > rulesForMetaObject;
+    };
+
+    const QVector<Rule> &rulesForClass(const QMetaObject *metaObject) const;
+
+    QSharedDataPointer<Data> d;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // THEMEMAPPING_H
@@ -0,0 +1,84 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#include <QWidget>
+
+#include "widgetstylebackup.h"
+
+using namespace CreatorStyleEdit::Internal;
+
+WidgetStyleBackup::WidgetStyleBackup()
+{
+}
+
+/*!
+ * \brief WidgetStyleBackup::record
+ *        Remember the style of the widget, if it isn't already known
+ */
+void WidgetStyleBackup::record(QWidget *widget)
+{
+    if (contains(widget))
+        return;
+
+    OriginalStyle originalStyle;
+    originalStyle.widget = widget;
+    originalStyle.styleSheet = widget->styleSheet();
+    originalStyle.hasOwnPalette = widget->testAttribute(Qt::WA_SetPalette);
+    if (originalStyle.hasOwnPalette)
+        originalStyle.palette = widget->palette();
+
+    m_originalStyles.append(originalStyle);
+}
+
+void WidgetStyleBackup::setStyleSheet(QWidget *widget, const QString &styleSheet)
+{
+    record(widget);
+    widget->setStyleSheet(styleSheet);
+}
+
+/*!
+ * \brief WidgetStyleBackup::restore
+ *        Set the original stylesheet and palette on all recorded widgets that still exist and
+ *        forget about them. Returns the number of restored widgets.
+ */
+int WidgetStyleBackup::restore()
+{
+    int restoredCount = 0;
+    foreach (const OriginalStyle &originalStyle, m_originalStyles) {
+        QWidget *widget = originalStyle.widget.data();
+        if (!widget)
+            continue;
+
+        // An empty stylesheet releases the QStyleSheetStyle of the widget and its cached rules
+        widget->setStyleSheet(originalStyle.styleSheet);
+        if (originalStyle.hasOwnPalette)
+            widget->setPalette(originalStyle.palette);
+        else
+            widget->setPalette(QPalette());
+
+        ++restoredCount;
+    }
+
+    m_originalStyles.clear();
+    return restoredCount;
+}
+
+int WidgetStyleBackup::count() const
+{
+    return m_originalStyles.count();
+}
+
+bool WidgetStyleBackup::contains(const QWidget *widget) const
+{
+    foreach (const OriginalStyle &originalStyle, m_originalStyles) {
+        if (originalStyle.widget == widget)
+            return true;
+    }
+
+    return false;
+}
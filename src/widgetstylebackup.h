@@ -0,0 +1,52 @@
+/**
+ * @author  Thomas Baumann <teebaum@ymail.com>
+ *
+ * @section LICENSE
+ * Licensed under the MIT License. See LICENSE for details.
+ *
+ */
+
+#ifndef WIDGETSTYLEBACKUP_H
+#define WIDGETSTYLEBACKUP_H
+
+#include <QList>
+#include <QPalette>
+#include <QPointer>
+#include <QString>
+
+class QWidget;
+
+namespace CreatorStyleEdit {
+namespace Internal {
+
+/*!
+ * \brief The WidgetStyleBackup class
+ *        Remembers the original stylesheet and palette of every widget a style is applied to,
+ *        so the style can be removed again without a restart.
+ */
+class WidgetStyleBackup
+{
+public:
+    WidgetStyleBackup();
+
+    void record(QWidget *widget);
+    void setStyleSheet(QWidget *widget, const QString &styleSheet);
+    int restore();
+    int count() const;
+    bool contains(const QWidget *widget) const;
+
+private:
+    struct OriginalStyle {
+        QPointer<QWidget> widget;
+        QString styleSheet;
+        QPalette palette;
+        bool hasOwnPalette;
+    };
+
+    QList<OriginalStyle> m_originalStyles;
+};
+
+} // namespace Internal
+} // namespace CreatorStyleEdit
+
+#endif // WIDGETSTYLEBACKUP_H